@@ -0,0 +1,533 @@
+#include "action_scheduler.h"
+
+#define SCHEDULE_NVS_KEY "entries"
+#define SECONDS_PER_DAY 86400
+
+#define SCHED_FLAG_ON 0x01
+#define SCHED_FLAG_DAILY 0x02    // at = local seconds since midnight
+#define SCHED_FLAG_ABSOLUTE 0x04 // at = Unix seconds (else remaining seconds)
+
+static const char *TAG = "SCHEDULER";
+
+typedef struct {
+    tw_node_t node; // First member: the wheel hands it back
+    bool used;
+    bool waiting_time; // Needs wall-clock time that is not synced yet
+    uint8_t actuator;
+    uint8_t flags;
+    uint32_t at;
+    uint32_t duration_s; // Revert after this long (0 = stay)
+} schedule_entry_t;
+
+// Persisted form of an entry
+typedef struct {
+    uint8_t actuator;
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t at;
+    uint32_t duration_s;
+} schedule_record_t;
+
+static schedule_entry_t entries[SCHEDULE_MAX];
+static schedule_record_t records[SCHEDULE_MAX];
+static timer_wheel_t wheel;
+static size_t used_count = 0;
+static size_t waiting_count = 0;
+static bool dirty = false;
+static SemaphoreHandle_t scheduler_mutex = NULL;
+static StaticSemaphore_t scheduler_mutex_buffer;
+static esp_timer_handle_t tick_timer = NULL;
+
+// NVS writer task
+static TaskHandle_t save_task = NULL;
+static StackType_t save_stack[SCHEDULE_SAVE_STACK];
+static StaticTask_t save_tcb;
+
+static uint32_t uptime_s(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000000);
+}
+
+// Unix seconds, 0 before the first SNTP sync
+static uint32_t unix_s(void) {
+    return (uint32_t)(time_sync_to_unix_ms(esp_timer_get_time()) / 1000);
+}
+
+static schedule_entry_t *alloc_entry(void) {
+    for (int i = 0; i < SCHEDULE_MAX; i++) {
+        if (!entries[i].used) {
+            memset(&entries[i], 0, sizeof(entries[i]));
+            entries[i].used = true;
+            used_count++;
+            return &entries[i];
+        }
+    }
+    return NULL;
+}
+
+static void free_entry(schedule_entry_t *entry) {
+    tw_cancel(&wheel, &entry->node);
+    if (entry->waiting_time) {
+        waiting_count--;
+    }
+    entry->used = false;
+    used_count--;
+    dirty = true;
+}
+
+// Put an entry on the wheel, or park it until the clock is synced
+static void arm(schedule_entry_t *entry) {
+    uint32_t now = unix_s();
+    uint32_t delay;
+
+    if (entry->flags & (SCHED_FLAG_DAILY | SCHED_FLAG_ABSOLUTE)) {
+        if (now == 0) {
+            if (!entry->waiting_time) {
+                entry->waiting_time = true;
+                waiting_count++;
+            }
+            return;
+        }
+        if (entry->waiting_time) {
+            entry->waiting_time = false;
+            waiting_count--;
+        }
+    }
+
+    if (entry->flags & SCHED_FLAG_DAILY) {
+        uint32_t local = (now + SCHEDULE_TZ_OFFSET_S) % SECONDS_PER_DAY;
+        delay = (entry->at + SECONDS_PER_DAY - local) % SECONDS_PER_DAY;
+        if (delay == 0) {
+            delay = SECONDS_PER_DAY;
+        }
+    } else if (entry->flags & SCHED_FLAG_ABSOLUTE) {
+        delay = entry->at > now ? entry->at - now : 0;
+    } else {
+        delay = entry->at;
+    }
+    tw_insert(&wheel, &entry->node, delay);
+}
+
+// Add a one-shot entry delay_s from now (absolute once the clock is synced)
+static schedule_entry_t *add_oneshot(uint8_t actuator, bool on, uint32_t delay_s, uint32_t duration_s) {
+    schedule_entry_t *entry = alloc_entry();
+    uint32_t now = unix_s();
+
+    if (entry == NULL) {
+        return NULL;
+    }
+    entry->actuator = actuator;
+    entry->flags = on ? SCHED_FLAG_ON : 0;
+    entry->duration_s = duration_s;
+    if (now != 0) {
+        entry->flags |= SCHED_FLAG_ABSOLUTE;
+        entry->at = now + delay_s;
+    } else {
+        entry->at = delay_s;
+    }
+    arm(entry);
+    dirty = true;
+    return entry;
+}
+
+// Wheel callback: run the action, schedule its revert and the next repeat
+static void on_expired(tw_node_t *node, void *ctx) {
+    schedule_entry_t *entry = (schedule_entry_t *)node;
+    bool on = (entry->flags & SCHED_FLAG_ON) != 0;
+
+    // The revert is reserved first: an action that could not be undone is skipped
+    if (entry->duration_s > 0 && add_oneshot(entry->actuator, !on, entry->duration_s, 0) == NULL) {
+        ESP_LOGW(TAG, "Schedule full, entry %d skipped (no room for its revert)",
+                 (int)(entry - entries));
+    } else {
+        ESP_LOGI(TAG, "Entry %d: %s %s", (int)(entry - entries),
+                 actuator_get(entry->actuator)->name, on ? "on" : "off");
+        actuator_set(entry->actuator, on);
+    }
+    if (entry->flags & SCHED_FLAG_DAILY) {
+        arm(entry);
+    } else {
+        free_entry(entry);
+    }
+}
+
+// Snapshot every entry for NVS; relative entries keep their remaining time
+// (caller holds the mutex)
+static size_t collect_records(void) {
+    size_t count = 0;
+
+    for (int i = 0; i < SCHEDULE_MAX; i++) {
+        schedule_entry_t *entry = &entries[i];
+        if (!entry->used) {
+            continue;
+        }
+        records[count] = (schedule_record_t) {
+            .actuator = entry->actuator,
+            .flags = entry->flags,
+            .at = entry->at,
+            .duration_s = entry->duration_s
+        };
+        if (!(entry->flags & (SCHED_FLAG_DAILY | SCHED_FLAG_ABSOLUTE)) && tw_pending(&entry->node)) {
+            records[count].at = entry->node.expires - wheel.now;
+        }
+        count++;
+    }
+    return count;
+}
+
+static esp_err_t write_records(size_t count) {
+    nvs_handle_t handle;
+
+    esp_err_t err = nvs_open(SCHEDULE_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = count ? nvs_set_blob(handle, SCHEDULE_NVS_KEY, records, count * sizeof(records[0]))
+                : nvs_erase_key(handle, SCHEDULE_NVS_KEY);
+    if (err == ESP_OK || err == ESP_ERR_NVS_NOT_FOUND) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+// Writer task: the blob (up to 3 KB) and its commit stall flash access, so
+// they never run in the esp_timer task or with the mutex held
+static void save_task_main(void *arg) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        xSemaphoreTake(scheduler_mutex, portMAX_DELAY);
+        size_t count = collect_records();
+        dirty = false;
+        xSemaphoreGive(scheduler_mutex);
+
+        esp_err_t err = write_records(count);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to save schedule: %s", esp_err_to_name(err));
+            xSemaphoreTake(scheduler_mutex, portMAX_DELAY);
+            dirty = true; // Retried on the next tick or command
+            xSemaphoreGive(scheduler_mutex);
+        }
+    }
+}
+
+// Hand changed entries to the writer task
+static void request_save(void) {
+    if (dirty && save_task != NULL) {
+        xTaskNotifyGive(save_task);
+    }
+}
+
+static void load_entries(void) {
+    nvs_handle_t handle;
+    size_t size = sizeof(records);
+
+    if (nvs_open(SCHEDULE_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return;
+    }
+    if (nvs_get_blob(handle, SCHEDULE_NVS_KEY, records, &size) == ESP_OK) {
+        for (size_t i = 0; i < size / sizeof(records[0]); i++) {
+            schedule_entry_t *entry;
+            if (records[i].actuator >= actuator_count() || (entry = alloc_entry()) == NULL) {
+                continue;
+            }
+            entry->actuator = records[i].actuator;
+            entry->flags = records[i].flags;
+            entry->at = records[i].at;
+            entry->duration_s = records[i].duration_s;
+            arm(entry);
+        }
+        ESP_LOGI(TAG, "Restored %u scheduled actions", (unsigned)used_count);
+    }
+    nvs_close(handle);
+}
+
+// Bring the wheel up to the current second
+static void catch_up(void) {
+    uint32_t now = uptime_s();
+
+    if (wheel.count == 0) {
+        tw_set_now(&wheel, now);
+        return;
+    }
+    while (wheel.now != now) {
+        tw_tick(&wheel, on_expired, NULL);
+    }
+}
+
+// Keep the single tick source running only while something is scheduled
+static void update_timer(void) {
+    bool needed = (used_count > 0);
+
+    if (needed && !esp_timer_is_active(tick_timer)) {
+        esp_timer_start_periodic(tick_timer, SCHEDULE_TICK_MS * 1000);
+    } else if (!needed && esp_timer_is_active(tick_timer)) {
+        esp_timer_stop(tick_timer);
+    }
+}
+
+static void tick_timer_callback(void *arg) {
+    xSemaphoreTake(scheduler_mutex, portMAX_DELAY);
+    catch_up();
+
+    // Wall-clock entries start once SNTP has synced
+    if (waiting_count > 0 && time_sync_is_synced()) {
+        for (int i = 0; i < SCHEDULE_MAX; i++) {
+            if (entries[i].used && entries[i].waiting_time) {
+                arm(&entries[i]);
+            }
+        }
+    }
+    request_save();
+    update_timer();
+    xSemaphoreGive(scheduler_mutex);
+}
+
+// Duration: seconds, or a number with an s/m/h suffix
+static bool parse_duration(const char *tok, uint32_t *seconds) {
+    char *end;
+    unsigned long value;
+    unsigned long unit = 1;
+
+    if (tok == NULL || (value = strtoul(tok, &end, 10)) == 0 || end == tok) {
+        return false;
+    }
+    if (*end == 'm') {
+        unit = 60;
+        end++;
+    } else if (*end == 'h') {
+        unit = 3600;
+        end++;
+    } else if (*end == 's') {
+        end++;
+    }
+    // Range check before scaling so large values cannot wrap
+    if (*end != '\0' || value > TW_MAX_DELAY / unit) {
+        return false;
+    }
+    *seconds = (uint32_t)(value * unit);
+    return true;
+}
+
+static bool parse_time_of_day(const char *tok, uint32_t *seconds) {
+    unsigned hours, minutes;
+    char extra;
+
+    if (tok == NULL || sscanf(tok, "%u:%u%c", &hours, &minutes, &extra) != 2 ||
+        hours > 23 || minutes > 59) {
+        return false;
+    }
+    *seconds = hours * 3600 + minutes * 60;
+    return true;
+}
+
+static int find_actuator(const char *tok) {
+    char *end;
+    long index = strtol(tok, &end, 10);
+
+    if (*end == '\0' && index >= 0 && (size_t)index < actuator_count()) {
+        return (int)index;
+    }
+    for (size_t i = 0; i < actuator_count(); i++) {
+        if (strcasecmp(tok, actuator_get(i)->name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+// Parse and apply one command (caller holds the mutex)
+static int run_command(char *text) {
+    char *save = NULL;
+    char *tok = strtok_r(text, " \t\r\n", &save);
+    uint32_t delay = 0, duration = 0, time_of_day = 0;
+    bool daily = false, absolute = false;
+    schedule_entry_t *entry;
+
+    if (tok == NULL) {
+        return -1;
+    }
+    if (strcmp(tok, "clear") == 0) {
+        for (int i = 0; i < SCHEDULE_MAX; i++) {
+            if (entries[i].used) {
+                free_entry(&entries[i]);
+            }
+        }
+        return 0;
+    }
+    if (strcmp(tok, "cancel") == 0) {
+        tok = strtok_r(NULL, " \t\r\n", &save);
+        char *end = NULL;
+        long id = tok ? strtol(tok, &end, 10) : -1;
+        if (tok == NULL || end == tok || *end != '\0' ||
+            id < 0 || id >= SCHEDULE_MAX || !entries[id].used) {
+            ESP_LOGW(TAG, "No entry %s", tok ? tok : "");
+            return -1;
+        }
+        free_entry(&entries[id]);
+        return 0;
+    }
+
+    int actuator = find_actuator(tok);
+    const char *state = strtok_r(NULL, " \t\r\n", &save);
+    if (actuator < 0 || state == NULL || (strcmp(state, "on") != 0 && strcmp(state, "off") != 0)) {
+        ESP_LOGW(TAG, "Expected <actuator> <on|off>");
+        return -1;
+    }
+    bool on = (strcmp(state, "on") == 0);
+
+    while ((tok = strtok_r(NULL, " \t\r\n", &save)) != NULL) {
+        const char *arg = (strcmp(tok, "daily") == 0) ? NULL : strtok_r(NULL, " \t\r\n", &save);
+        bool ok;
+
+        if (strcmp(tok, "daily") == 0) {
+            ok = daily = true;
+        } else if (strcmp(tok, "for") == 0) {
+            ok = parse_duration(arg, &duration);
+        } else if (strcmp(tok, "in") == 0) {
+            ok = parse_duration(arg, &delay);
+        } else if (strcmp(tok, "at") == 0) {
+            ok = absolute = parse_time_of_day(arg, &time_of_day);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            ESP_LOGW(TAG, "Invalid schedule argument: %s %s", tok, arg ? arg : "");
+            return -1;
+        }
+    }
+    if ((daily && !absolute) || (absolute && delay)) {
+        ESP_LOGW(TAG, "Use either 'in <dur>' or 'at HH:MM [daily]'");
+        return -1;
+    }
+
+    // Plain "on for 15m": act now and only schedule the revert, reserved
+    // first so a full table never leaves the output on for good
+    if (!absolute && delay == 0) {
+        if (duration == 0) {
+            actuator_set(actuator, on);
+            return 0;
+        }
+        if ((entry = add_oneshot((uint8_t)actuator, !on, duration, 0)) == NULL) {
+            ESP_LOGW(TAG, "Schedule full (%d entries)", SCHEDULE_MAX);
+            return -1;
+        }
+        actuator_set(actuator, on);
+        return (int)(entry - entries);
+    }
+
+    if (daily) {
+        if ((entry = alloc_entry()) != NULL) {
+            entry->actuator = (uint8_t)actuator;
+            entry->flags = (on ? SCHED_FLAG_ON : 0) | SCHED_FLAG_DAILY;
+            entry->at = time_of_day;
+            entry->duration_s = duration;
+            arm(entry);
+            dirty = true;
+        }
+    } else if (absolute) {
+        // A one-time "at" is the next occurrence of that local time
+        uint32_t now = unix_s();
+        if (now == 0) {
+            ESP_LOGW(TAG, "Time not synced, use 'in' or 'daily'");
+            return -1;
+        }
+        delay = (time_of_day + SECONDS_PER_DAY - (now + SCHEDULE_TZ_OFFSET_S) % SECONDS_PER_DAY) % SECONDS_PER_DAY;
+        entry = add_oneshot((uint8_t)actuator, on, delay ? delay : SECONDS_PER_DAY, duration);
+    } else {
+        entry = add_oneshot((uint8_t)actuator, on, delay, duration);
+    }
+
+    if (entry == NULL) {
+        ESP_LOGW(TAG, "Schedule full (%d entries)", SCHEDULE_MAX);
+        return -1;
+    }
+    return (int)(entry - entries);
+}
+
+// Schedule command on FEED_SCHEDULE
+static void process_schedule_message(const char *topic, size_t topic_len,
+                                     const char *data, size_t data_len, void *ctx) {
+    action_scheduler_command(data, data_len);
+}
+
+int action_scheduler_command(const char *text, size_t len) {
+    char buf[SCHEDULE_COMMAND_MAX];
+    int id;
+
+    if (len >= sizeof(buf)) {
+        ESP_LOGW(TAG, "Schedule command too long (%u bytes)", (unsigned)len);
+        return -1;
+    }
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+
+    xSemaphoreTake(scheduler_mutex, portMAX_DELAY);
+    catch_up();
+    id = run_command(buf);
+    request_save();
+    update_timer();
+    xSemaphoreGive(scheduler_mutex);
+
+    if (id < 0) {
+        ESP_LOGW(TAG, "Rejected schedule command: %.*s", (int)len, text);
+    }
+    return id;
+}
+
+bool action_scheduler_describe(int id, char *out, size_t out_size) {
+    bool found = false;
+
+    if (id < 0 || id >= SCHEDULE_MAX) {
+        return false;
+    }
+    xSemaphoreTake(scheduler_mutex, portMAX_DELAY);
+    const schedule_entry_t *entry = &entries[id];
+    if (entry->used) {
+        const char *name = actuator_get(entry->actuator)->name;
+        const char *state = (entry->flags & SCHED_FLAG_ON) ? "on" : "off";
+        char duration[24] = "";
+        char when[32];
+
+        if (entry->duration_s) {
+            snprintf(duration, sizeof(duration), " for %u s", (unsigned)entry->duration_s);
+        }
+        if (entry->flags & SCHED_FLAG_DAILY) {
+            snprintf(when, sizeof(when), "at %02u:%02u daily",
+                     (unsigned)(entry->at / 3600), (unsigned)(entry->at / 60 % 60));
+        } else if (entry->waiting_time) {
+            snprintf(when, sizeof(when), "waiting for time");
+        } else {
+            snprintf(when, sizeof(when), "in %u s", (unsigned)(entry->node.expires - wheel.now));
+        }
+        snprintf(out, out_size, "%s %s %s%s%s", name, state, when, duration,
+                 (entry->flags & SCHED_FLAG_DAILY) && entry->waiting_time ? " (waiting for time)" : "");
+        found = true;
+    }
+    xSemaphoreGive(scheduler_mutex);
+    return found;
+}
+
+size_t action_scheduler_count(void) {
+    return used_count;
+}
+
+void action_scheduler_init(void) {
+    scheduler_mutex = xSemaphoreCreateMutexStatic(&scheduler_mutex_buffer);
+    tw_init(&wheel, uptime_s());
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = tick_timer_callback,
+        .name = "schedule_tick"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&timer_args, &tick_timer));
+    save_task = xTaskCreateStatic(save_task_main, "sched_save", sizeof(save_stack), NULL,
+                                  SCHEDULE_SAVE_PRIORITY, save_stack, &save_tcb);
+
+    xSemaphoreTake(scheduler_mutex, portMAX_DELAY);
+    load_entries();
+    update_timer();
+    xSemaphoreGive(scheduler_mutex);
+
+    topic_router_register(FEED_SCHEDULE, process_schedule_message, NULL);
+}
@@ -0,0 +1,53 @@
+// action_scheduler.h
+#ifndef ACTION_SCHEDULER_H
+#define ACTION_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "static_mem.h"
+#include "nvs.h"
+#include "global_data.h"
+#include "timer_wheel.h"
+#include "actuator.h"
+#include "time_sync.h"
+#include "topic_router.h"
+
+// Timed actuator actions that run on the node (no broker needed):
+//   <actuator> <on|off> [for <dur>]                    now, revert after dur
+//   <actuator> <on|off> in <dur> [for <dur>]
+//   <actuator> <on|off> at <HH:MM> [daily] [for <dur>]  local time, needs SNTP
+//   cancel <id> | clear
+// actuator: name (LED1) or index; dur: seconds, or with an s/m/h suffix
+#define SCHEDULE_MAX 256
+#define SCHEDULE_TICK_MS 1000 // Wheel tick (one esp_timer, stopped when idle)
+#define SCHEDULE_TZ_OFFSET_S (CONFIG_APP_SCHEDULE_TZ_OFFSET_MIN * 60) // Local time for "at"
+#define SCHEDULE_COMMAND_MAX 96
+#define SCHEDULE_NVS_NAMESPACE "schedule"
+#define SCHEDULE_SAVE_STACK 3072 // NVS writer, keeps flash writes off esp_timer
+#define SCHEDULE_SAVE_PRIORITY 1
+
+// Restore the stored schedules and route FEED_SCHEDULE (call after
+// actuator_init, before the MQTT task starts)
+void action_scheduler_init(void);
+
+// Run one command. Returns the id of the created entry (or 0 for cancel and
+// clear), or -1 with the reason logged.
+int action_scheduler_command(const char *text, size_t len);
+
+// Human-readable entry, false if id is not in use
+bool action_scheduler_describe(int id, char *out, size_t out_size);
+
+size_t action_scheduler_count(void);
+
+#endif // ACTION_SCHEDULER_H
@@ -0,0 +1,162 @@
+#include "actuator.h"
+
+static const char *TAG = "ACTUATOR";
+
+// Board table: add relays here (feed topic, GPIO, polarity)
+static const actuator_def_t board_actuators[] = {
+    { "LED1", CONFIG_FEED_LED1, LED1_GPIO, false },
+    { "LED2", CONFIG_FEED_LED2, LED2_GPIO, false },
+};
+
+#define BOARD_ACTUATOR_COUNT (sizeof(board_actuators) / sizeof(board_actuators[0]))
+_Static_assert(BOARD_ACTUATOR_COUNT <= ACTUATOR_MAX, "too many actuators");
+
+// Per-bank pin masks of each actuator, precomputed at init
+typedef struct {
+    uint32_t bank0; // GPIO 0-31
+    uint32_t bank1; // GPIO 32-39
+} pin_mask_t;
+
+static pin_mask_t pins[ACTUATOR_MAX];
+static uint32_t all_mask = 0;
+static uint32_t active_low_mask = 0;
+
+static portMUX_TYPE state_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t desired = 0;
+static uint32_t applied = 0;
+static volatile uint32_t actual = 0;
+static esp_timer_handle_t debounce_timer = NULL;
+
+// Output levels of every actuator as a state mask
+static uint32_t read_back(void) {
+    uint32_t out0 = GPIO.out;
+    uint32_t out1 = GPIO.out1.data;
+    uint32_t levels = 0;
+
+    for (size_t i = 0; i < BOARD_ACTUATOR_COUNT; i++) {
+        if ((out0 & pins[i].bank0) || (out1 & pins[i].bank1)) {
+            levels |= 1u << i;
+        }
+    }
+    return levels ^ active_low_mask;
+}
+
+// Drive the pins of the actuators in changed to their state in states with
+// one set and one clear register write per bank
+static void write_pins(uint32_t states, uint32_t changed) {
+    uint32_t high = (states ^ active_low_mask) & changed;
+    uint32_t low = ~(states ^ active_low_mask) & changed;
+    uint32_t set0 = 0, clr0 = 0, set1 = 0, clr1 = 0;
+
+    for (size_t i = 0; i < BOARD_ACTUATOR_COUNT; i++) {
+        if (high & (1u << i)) {
+            set0 |= pins[i].bank0;
+            set1 |= pins[i].bank1;
+        } else if (low & (1u << i)) {
+            clr0 |= pins[i].bank0;
+            clr1 |= pins[i].bank1;
+        }
+    }
+
+    if (set0) {
+        GPIO.out_w1ts = set0;
+    }
+    if (clr0) {
+        GPIO.out_w1tc = clr0;
+    }
+    if (set1) {
+        GPIO.out1_w1ts.data = set1;
+    }
+    if (clr1) {
+        GPIO.out1_w1tc.data = clr1;
+    }
+}
+
+// Debounce timer: apply the coalesced requests and report the actual state
+static void apply_pending(void *arg) {
+    portENTER_CRITICAL(&state_lock);
+    uint32_t target = desired;
+    uint32_t changed = target ^ applied;
+    applied = target;
+    portEXIT_CRITICAL(&state_lock);
+
+    if (changed == 0) {
+        return; // Burst cancelled itself out
+    }
+
+    write_pins(target, changed);
+    actual = read_back();
+    mqtt_bench_on_gpio_update();
+
+    char payload[48];
+    snprintf(payload, sizeof(payload), "{\"state\":%u,\"changed\":%u}", actual, changed);
+    publish_scheduler_submit(FEED_ACTUATORS, payload, 0, 1, 1, PUBLISH_PRIO_STATE);
+
+    ESP_LOGI(TAG, "State 0x%08x (changed 0x%08x)%s", actual, changed,
+             actual != target ? ", read-back mismatch" : "");
+}
+
+void actuator_init(void) {
+    for (size_t i = 0; i < BOARD_ACTUATOR_COUNT; i++) {
+        const actuator_def_t *def = &board_actuators[i];
+
+        gpio_reset_pin(def->gpio);
+        gpio_set_direction(def->gpio, GPIO_MODE_OUTPUT);
+        if (def->gpio < 32) {
+            pins[i].bank0 = 1u << def->gpio;
+        } else {
+            pins[i].bank1 = 1u << (def->gpio - 32);
+        }
+        all_mask |= 1u << i;
+        if (def->active_low) {
+            active_low_mask |= 1u << i;
+        }
+    }
+
+    write_pins(0, all_mask);
+    actual = read_back();
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = apply_pending,
+        .name = "actuator_debounce"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&timer_args, &debounce_timer));
+
+    ESP_LOGI(TAG, "%u actuators registered", (unsigned)BOARD_ACTUATOR_COUNT);
+}
+
+size_t actuator_count(void) {
+    return BOARD_ACTUATOR_COUNT;
+}
+
+const actuator_def_t *actuator_get(size_t index) {
+    return index < BOARD_ACTUATOR_COUNT ? &board_actuators[index] : NULL;
+}
+
+uint32_t actuator_all_mask(void) {
+    return all_mask;
+}
+
+void actuator_set_mask(uint32_t states, uint32_t mask) {
+    mask &= all_mask;
+
+    portENTER_CRITICAL(&state_lock);
+    desired = (desired & ~mask) | (states & mask);
+    bool pending = (desired != applied);
+    portEXIT_CRITICAL(&state_lock);
+
+    // The window starts at the first change; later ones ride along
+    if (pending && !esp_timer_is_active(debounce_timer)) {
+        esp_timer_start_once(debounce_timer, ACTUATOR_DEBOUNCE_MS * 1000);
+    }
+}
+
+void actuator_set(size_t index, bool on) {
+    if (index < BOARD_ACTUATOR_COUNT) {
+        actuator_set_mask(on ? 1u << index : 0, 1u << index);
+    }
+}
+
+uint32_t actuator_state(void) {
+    return actual;
+}
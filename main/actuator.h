@@ -0,0 +1,46 @@
+// actuator.h
+#ifndef ACTUATOR_H
+#define ACTUATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+#include "soc/gpio_struct.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "static_mem.h"
+#include "global_data.h"
+#include "publish_scheduler.h"
+#include "mqtt_bench.h"
+
+// Registry capacity (one state bit per actuator)
+#define ACTUATOR_MAX 24
+// Commands arriving within this window are applied together
+#define ACTUATOR_DEBOUNCE_MS 50
+
+typedef struct {
+    const char *name;
+    const char *topic;   // Command feed ("1"/"0")
+    gpio_num_t gpio;
+    bool active_low;
+} actuator_def_t;
+
+// Register the board actuators, drive them all off (call once at boot)
+void actuator_init(void);
+
+size_t actuator_count(void);
+const actuator_def_t *actuator_get(size_t index);
+uint32_t actuator_all_mask(void);
+
+// Request new states; changes within ACTUATOR_DEBOUNCE_MS are coalesced and
+// only the pins that differ from the applied state are written
+void actuator_set(size_t index, bool on);
+void actuator_set_mask(uint32_t states, uint32_t mask);
+
+// States read back from the output registers after the last write
+uint32_t actuator_state(void);
+
+#endif // ACTUATOR_H
@@ -0,0 +1,59 @@
+#include "alarm_events.h"
+
+#define ALARM_EVENT_NAME_MAX 16
+
+static const char *TAG = "ALARM_EVENTS";
+
+static const char *const source_names[ALARM_SOURCE_COUNT] = { "temperature", "sensor", "prediction" };
+
+static portMUX_TYPE events_lock = portMUX_INITIALIZER_UNLOCKED;
+static char last_event[ALARM_SOURCE_COUNT][ALARM_EVENT_NAME_MAX];
+static uint32_t next_seq = 0;
+
+bool alarm_events_publish(alarm_source_t source, const char *event, float value,
+                          int64_t timestamp_us) {
+    char payload[160];
+    char previous[ALARM_EVENT_NAME_MAX];
+    uint32_t seq;
+
+    if (source >= ALARM_SOURCE_COUNT) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&events_lock);
+    bool repeat = (strncmp(last_event[source], event, ALARM_EVENT_NAME_MAX) == 0);
+    if (!repeat) {
+        memcpy(previous, last_event[source], sizeof(previous));
+        strncpy(last_event[source], event, ALARM_EVENT_NAME_MAX - 1);
+        seq = next_seq++;
+    }
+    portEXIT_CRITICAL(&events_lock);
+
+    if (repeat) {
+        ESP_LOGD(TAG, "Duplicate %s event suppressed: %s", source_names[source], event);
+        return false;
+    }
+
+    uint64_t unix_ms = time_sync_to_unix_ms(timestamp_us);
+    bool synced = (unix_ms != 0);
+    snprintf(payload, sizeof(payload),
+             "{\"source\":\"%s\",\"event\":\"%s\",\"value\":%.1f,\"ts\":%llu,\"synced\":%s,\"seq\":%u}",
+             source_names[source], event, value,
+             synced ? (unsigned long long)unix_ms : (unsigned long long)(timestamp_us / 1000),
+             synced ? "true" : "false", seq);
+
+    // The alarm class is sent first and keeps a reserved token, so the event
+    // goes out on the next scheduler pass even with telemetry queued
+    if (!publish_scheduler_submit(FEED_ALARM, payload, 0, 1, 0, PUBLISH_PRIO_ALARM)) {
+        // Roll back so the same event is not suppressed when it is raised again
+        portENTER_CRITICAL(&events_lock);
+        if (strncmp(last_event[source], event, ALARM_EVENT_NAME_MAX - 1) == 0) {
+            memcpy(last_event[source], previous, sizeof(previous));
+        }
+        portEXIT_CRITICAL(&events_lock);
+        ESP_LOGW(TAG, "Alarm event not queued: %s", payload);
+        return false;
+    }
+    ESP_LOGI(TAG, "Alarm event queued: %s", payload);
+    return true;
+}
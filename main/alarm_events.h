@@ -0,0 +1,31 @@
+// alarm_events.h
+#ifndef ALARM_EVENTS_H
+#define ALARM_EVENTS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "global_data.h"
+#include "publish_scheduler.h"
+#include "time_sync.h"
+
+// Event sources; each one deduplicates its own repeats
+typedef enum {
+    ALARM_SOURCE_TEMPERATURE = 0, // Alarm level changes
+    ALARM_SOURCE_SENSOR,          // Sensor failure / recovery
+    ALARM_SOURCE_PREDICTION,      // Trend pre-alarm / clear
+    ALARM_SOURCE_COUNT
+} alarm_source_t;
+
+// Publish an alarm event at QoS 1 ahead of all queued telemetry:
+//   {"source":"temperature","event":"critical","value":41.0,"ts":<ms>,"synced":true,"seq":3}
+// ts is Unix time once SNTP has synced, else ms since boot. Returns false
+// (nothing sent) when the event repeats the last one of its source.
+bool alarm_events_publish(alarm_source_t source, const char *event, float value,
+                          int64_t timestamp_us);
+
+#endif // ALARM_EVENTS_H
@@ -0,0 +1,231 @@
+#include "alarm_monitor.h"
+
+#define ALARM_NVS_KEY "config"
+
+static const char *TAG = "ALARM";
+
+static alarm_config_t config = {
+    .warning_c = ALARM_WARNING_DEFAULT,
+    .critical_c = ALARM_CRITICAL_DEFAULT,
+    .hysteresis_c = ALARM_HYSTERESIS_DEFAULT,
+    .warning_hold_ms = ALARM_WARNING_HOLD_DEFAULT_MS,
+    .critical_hold_ms = ALARM_CRITICAL_HOLD_DEFAULT_MS,
+    .prealarm_horizon_s = ALARM_PREALARM_HORIZON_DEFAULT_S
+};
+static portMUX_TYPE config_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Evaluation state, only touched from the sensor task
+static alarm_level_t level = ALARM_LEVEL_NORMAL;
+static int64_t above_since_us[ALARM_LEVEL_COUNT];
+static uint32_t failed_reads = 0;
+static volatile bool rule_alert = false;
+static prealarm_t prealarm;
+
+// Post the pattern for the current state (critical outranks a sensor failure,
+// which outranks a warning, a pre-alarm or a rule alert)
+static void update_annunciator(void) {
+    if (level == ALARM_LEVEL_CRITICAL) {
+        buzzer_play(BUZZER_PATTERN_CRITICAL);
+    } else if (failed_reads >= ALARM_SENSOR_FAIL_READS) {
+        buzzer_play(BUZZER_PATTERN_SENSOR_FAILURE);
+    } else if (level == ALARM_LEVEL_WARNING || prealarm.active || rule_alert) {
+        buzzer_play(BUZZER_PATTERN_WARNING);
+    } else {
+        buzzer_play(BUZZER_PATTERN_OFF);
+    }
+}
+
+// Drive the outputs and report a new level
+static void apply_level(alarm_level_t new_level, float temp, int64_t timestamp_us) {
+    if (new_level == level) {
+        return;
+    }
+
+    overheat_alarm = (new_level == ALARM_LEVEL_CRITICAL);
+
+    if (new_level > level) {
+        ESP_LOGW(TAG, "Temperature %s: %.1f°C", alarm_level_name(new_level), temp);
+    } else {
+        ESP_LOGI(TAG, "Temperature back to %s: %.1f°C", alarm_level_name(new_level), temp);
+    }
+    level = new_level;
+    update_annunciator();
+    alarm_events_publish(ALARM_SOURCE_TEMPERATURE, alarm_level_name(new_level), temp, timestamp_us);
+}
+
+// Report a pre-alarm change (a pre-alarm is moot once critical)
+static void apply_prealarm(float time_to_s, int64_t timestamp_us) {
+    if (prealarm.active) {
+        if (level == ALARM_LEVEL_CRITICAL) {
+            return;
+        }
+        ESP_LOGW(TAG, "Pre-alarm: critical %.1f°C projected in %.0f s", config.critical_c, time_to_s);
+        alarm_events_publish(ALARM_SOURCE_PREDICTION, "prealarm", time_to_s, timestamp_us);
+    } else {
+        ESP_LOGI(TAG, "Pre-alarm cleared");
+        alarm_events_publish(ALARM_SOURCE_PREDICTION, "clear", time_to_s, timestamp_us);
+    }
+    update_annunciator();
+}
+
+// Track how long a level's condition has held; returns true once qualified
+static bool level_holds(alarm_level_t candidate, float temp, float threshold,
+                        uint32_t hold_ms, float hysteresis, int64_t now) {
+    // An active level only clears below its hysteresis band
+    bool above = (level >= candidate) ? (temp > threshold - hysteresis) : (temp >= threshold);
+
+    if (!above) {
+        above_since_us[candidate] = 0;
+        return false;
+    }
+    if (above_since_us[candidate] == 0) {
+        above_since_us[candidate] = now;
+    }
+    return level >= candidate || now - above_since_us[candidate] >= (int64_t)hold_ms * 1000;
+}
+
+// Sample listener: one O(1) evaluation per reading
+static void on_sample(const sensor_sample_t *sample) {
+    alarm_config_t cfg;
+
+    // Failed reads (-99) carry no temperature; keep the current level
+    if (!sample->valid) {
+        if (++failed_reads == ALARM_SENSOR_FAIL_READS) {
+            ESP_LOGW(TAG, "Sensor failure: %u consecutive failed reads", failed_reads);
+            update_annunciator();
+            alarm_events_publish(ALARM_SOURCE_SENSOR, "failure", (float)failed_reads,
+                                 sample->timestamp_us);
+        }
+        return;
+    }
+    bool recovered = (failed_reads >= ALARM_SENSOR_FAIL_READS);
+    failed_reads = 0;
+    if (recovered) {
+        ESP_LOGI(TAG, "Sensor recovered");
+        update_annunciator();
+        alarm_events_publish(ALARM_SOURCE_SENSOR, "recovered", sample->temperature,
+                             sample->timestamp_us);
+    }
+
+    portENTER_CRITICAL(&config_lock);
+    cfg = config;
+    portEXIT_CRITICAL(&config_lock);
+
+    float temp = sample->temperature;
+    bool critical = level_holds(ALARM_LEVEL_CRITICAL, temp, cfg.critical_c,
+                                cfg.critical_hold_ms, cfg.hysteresis_c, sample->timestamp_us);
+    bool warning = level_holds(ALARM_LEVEL_WARNING, temp, cfg.warning_c,
+                               cfg.warning_hold_ms, cfg.hysteresis_c, sample->timestamp_us);
+
+    if (critical) {
+        apply_level(ALARM_LEVEL_CRITICAL, temp, sample->timestamp_us);
+    } else if (warning) {
+        apply_level(ALARM_LEVEL_WARNING, temp, sample->timestamp_us);
+    } else {
+        apply_level(ALARM_LEVEL_NORMAL, temp, sample->timestamp_us);
+    }
+
+    // Early warning from the trend towards the critical threshold
+    float time_to_s;
+    if (prealarm_update(&prealarm, (uint32_t)(sample->timestamp_us / 1000), temp, cfg.critical_c,
+                        (float)cfg.prealarm_horizon_s, &time_to_s)) {
+        apply_prealarm(time_to_s, sample->timestamp_us);
+    }
+}
+
+// Load the configuration from NVS, keeping the defaults if absent
+// Every comparison with NaN is false, so finiteness is checked first
+static bool config_valid(const alarm_config_t *c) {
+    return isfinite(c->warning_c) && isfinite(c->critical_c) && isfinite(c->hysteresis_c) &&
+           c->warning_c >= ALARM_TEMP_MIN_C && c->critical_c <= ALARM_TEMP_MAX_C &&
+           c->warning_c <= c->critical_c &&
+           c->hysteresis_c >= 0.0f && c->hysteresis_c <= ALARM_HYSTERESIS_MAX &&
+           c->warning_hold_ms <= ALARM_HOLD_MAX_MS && c->critical_hold_ms <= ALARM_HOLD_MAX_MS &&
+           c->prealarm_horizon_s <= ALARM_PREALARM_HORIZON_MAX_S;
+}
+
+static void load_config(void) {
+    nvs_handle_t handle;
+    alarm_config_t stored = config;
+    size_t size = sizeof(stored);
+
+    if (nvs_open(ALARM_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return;
+    }
+    if (nvs_get_blob(handle, ALARM_NVS_KEY, &stored, &size) == ESP_OK && size == sizeof(stored)) {
+        if (config_valid(&stored)) {
+            config = stored;
+        } else {
+            ESP_LOGW(TAG, "Stored alarm config is invalid, using defaults");
+        }
+    }
+    nvs_close(handle);
+}
+
+void alarm_monitor_init(void) {
+    buzzer_init();
+    prealarm_init(&prealarm, ALARM_PREALARM_WINDOW);
+    load_config();
+    dht11_register_listener(on_sample);
+
+    ESP_LOGI(TAG, "Alarm monitoring started (warning %.1f°C, critical %.1f°C, hysteresis %.1f°C)",
+             config.warning_c, config.critical_c, config.hysteresis_c);
+}
+
+void alarm_monitor_get_config(alarm_config_t *out) {
+    portENTER_CRITICAL(&config_lock);
+    *out = config;
+    portEXIT_CRITICAL(&config_lock);
+}
+
+esp_err_t alarm_monitor_set_config(const alarm_config_t *updated) {
+    nvs_handle_t handle;
+
+    if (!config_valid(updated)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&config_lock);
+    config = *updated;
+    portEXIT_CRITICAL(&config_lock);
+
+    ESP_LOGI(TAG, "Alarm thresholds: warning %.1f°C (%u ms), critical %.1f°C (%u ms), "
+             "hysteresis %.1f°C, pre-alarm horizon %u s",
+             updated->warning_c, updated->warning_hold_ms, updated->critical_c,
+             updated->critical_hold_ms, updated->hysteresis_c, updated->prealarm_horizon_s);
+
+    esp_err_t err = nvs_open(ALARM_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_blob(handle, ALARM_NVS_KEY, updated, sizeof(*updated));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+void alarm_monitor_set_rule_alert(bool active) {
+    rule_alert = active;
+    update_annunciator();
+}
+
+alarm_level_t alarm_monitor_level(void) {
+    return level;
+}
+
+bool alarm_monitor_prealarm(void) {
+    return prealarm.active && level != ALARM_LEVEL_CRITICAL;
+}
+
+const char *alarm_level_name(alarm_level_t lvl) {
+    switch (lvl) {
+        case ALARM_LEVEL_WARNING:
+            return "warning";
+        case ALARM_LEVEL_CRITICAL:
+            return "critical";
+        default:
+            return "normal";
+    }
+}
@@ -0,0 +1,72 @@
+// alarm_monitor.h
+#ifndef ALARM_MONITOR_H
+#define ALARM_MONITOR_H
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "nvs.h"
+#include "global_data.h"
+#include "dht11_task.h"
+#include "buzzer.h"
+#include "alarm_events.h"
+#include "trend_predict.h"
+
+#define ALARM_NVS_NAMESPACE "alarm"
+
+// Defaults (critical is the historical overheat threshold)
+#define ALARM_WARNING_DEFAULT (TEMPERATURE_THRESHOLD - 5.0f)
+#define ALARM_CRITICAL_DEFAULT TEMPERATURE_THRESHOLD
+#define ALARM_HYSTERESIS_DEFAULT 1.0f
+#define ALARM_HYSTERESIS_MAX 10.0f
+#define ALARM_WARNING_HOLD_DEFAULT_MS 10000
+#define ALARM_CRITICAL_HOLD_DEFAULT_MS 2000
+#define ALARM_HOLD_MAX_MS 3600000
+#define ALARM_TEMP_MIN_C -40.0f // Accepted threshold range
+#define ALARM_TEMP_MAX_C 125.0f
+#define ALARM_PREALARM_HORIZON_DEFAULT_S 120 // 0 disables the pre-alarm
+#define ALARM_PREALARM_HORIZON_MAX_S 3600
+#define ALARM_PREALARM_WINDOW 45 // Samples in the trend fit (90 s at 2 s)
+#define ALARM_SENSOR_FAIL_READS 3 // Consecutive failed reads before the failure pattern
+
+typedef enum {
+    ALARM_LEVEL_NORMAL = 0,
+    ALARM_LEVEL_WARNING,
+    ALARM_LEVEL_CRITICAL,
+    ALARM_LEVEL_COUNT
+} alarm_level_t;
+
+// A level is raised once the temperature has stayed at or above its threshold
+// for its hold time, and cleared when it falls hysteresis_c below it. The
+// pre-alarm fires when the temperature trend reaches critical_c within
+// prealarm_horizon_s.
+typedef struct {
+    float warning_c;
+    float critical_c;
+    float hysteresis_c;
+    uint32_t warning_hold_ms;
+    uint32_t critical_hold_ms;
+    uint32_t prealarm_horizon_s;
+} alarm_config_t;
+
+// Load the stored configuration and attach to the sensor samples
+// (call before the DHT11 task starts)
+void alarm_monitor_init(void);
+
+void alarm_monitor_get_config(alarm_config_t *config);
+
+// Validate, apply and store a configuration
+esp_err_t alarm_monitor_set_config(const alarm_config_t *config);
+
+// Sound the warning pattern while a rule with the buzzer action is firing
+void alarm_monitor_set_rule_alert(bool active);
+
+alarm_level_t alarm_monitor_level(void);
+bool alarm_monitor_prealarm(void); // Pre-alarm active and not yet critical
+const char *alarm_level_name(alarm_level_t level);
+
+#endif // ALARM_MONITOR_H
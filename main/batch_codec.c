@@ -0,0 +1,282 @@
+#include "batch_codec.h"
+#include <string.h>
+
+// LZSS parameters: 8 tokens per control byte, one-byte offset and length
+#define LZ_WINDOW 256
+#define LZ_MIN_MATCH 3
+#define LZ_MAX_MATCH (LZ_MIN_MATCH + 255)
+
+static const char base64_chars[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+typedef struct {
+    uint8_t *buf;
+    size_t size;
+    size_t pos;
+    bool overflow;
+} byte_writer_t;
+
+typedef struct {
+    const uint8_t *buf;
+    size_t size;
+    size_t pos;
+    bool error;
+} byte_reader_t;
+
+static void put_byte(byte_writer_t *w, uint8_t value) {
+    if (w->pos >= w->size) {
+        w->overflow = true;
+        return;
+    }
+    w->buf[w->pos++] = value;
+}
+
+static void put_varint(byte_writer_t *w, uint64_t value) {
+    do {
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        put_byte(w, byte | (value ? 0x80 : 0));
+    } while (value);
+}
+
+static void put_zigzag(byte_writer_t *w, int32_t value) {
+    put_varint(w, ((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+}
+
+static uint8_t get_byte(byte_reader_t *r) {
+    if (r->pos >= r->size) {
+        r->error = true;
+        return 0;
+    }
+    return r->buf[r->pos++];
+}
+
+static uint64_t get_varint(byte_reader_t *r) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64 && !r->error; shift += 7) {
+        uint8_t byte = get_byte(r);
+        value |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    r->error = true;
+    return 0;
+}
+
+static int32_t get_zigzag(byte_reader_t *r) {
+    uint32_t value = (uint32_t)get_varint(r);
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+// Compress with LZSS; returns false if out is too small
+static bool lz_compress(const uint8_t *in, size_t len, byte_writer_t *w) {
+    size_t pos = 0;
+
+    while (pos < len) {
+        size_t control_pos = w->pos;
+        uint8_t control = 0;
+        put_byte(w, 0);
+
+        for (int token = 0; token < 8 && pos < len; token++) {
+            size_t best_len = 0;
+            size_t best_dist = 0;
+            size_t max_dist = pos < LZ_WINDOW ? pos : LZ_WINDOW;
+
+            for (size_t dist = 1; dist <= max_dist; dist++) {
+                size_t match = 0;
+                while (match < LZ_MAX_MATCH && pos + match < len &&
+                       in[pos + match] == in[pos + match - dist]) {
+                    match++;
+                }
+                if (match > best_len) {
+                    best_len = match;
+                    best_dist = dist;
+                }
+            }
+
+            if (best_len >= LZ_MIN_MATCH) {
+                control |= 1 << token;
+                put_byte(w, (uint8_t)(best_dist - 1));
+                put_byte(w, (uint8_t)(best_len - LZ_MIN_MATCH));
+                pos += best_len;
+            } else {
+                put_byte(w, in[pos++]);
+            }
+        }
+
+        if (!w->overflow) {
+            w->buf[control_pos] = control;
+        }
+    }
+    return !w->overflow;
+}
+
+// Decompress exactly out_len bytes; returns false on malformed input
+static bool lz_decompress(byte_reader_t *r, uint8_t *out, size_t out_len) {
+    size_t pos = 0;
+
+    while (pos < out_len) {
+        uint8_t control = get_byte(r);
+        for (int token = 0; token < 8 && pos < out_len; token++) {
+            if (control & (1 << token)) {
+                size_t dist = (size_t)get_byte(r) + 1;
+                size_t match = (size_t)get_byte(r) + LZ_MIN_MATCH;
+                if (r->error || dist > pos || pos + match > out_len) {
+                    return false;
+                }
+                for (size_t i = 0; i < match; i++, pos++) {
+                    out[pos] = out[pos - dist];
+                }
+            } else {
+                out[pos++] = get_byte(r);
+            }
+            if (r->error) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+size_t batch_encode(const batch_sample_t *samples, size_t count,
+                    uint64_t base_time_ms, uint8_t flags,
+                    uint8_t *scratch, size_t scratch_size,
+                    uint8_t *out, size_t out_size) {
+    byte_writer_t raw = { scratch, scratch_size, 0, false };
+
+    put_varint(&raw, count);
+    put_varint(&raw, base_time_ms);
+    put_byte(&raw, flags);
+
+    // Regular sampling makes delta-of-delta timestamps mostly zero
+    int64_t prev_offset = 0;
+    int64_t prev_interval = 0;
+    for (size_t i = 0; i < count; i++) {
+        int64_t interval = (int64_t)samples[i].offset_ms - prev_offset;
+        put_zigzag(&raw, (int32_t)(interval - prev_interval));
+        prev_offset = samples[i].offset_ms;
+        prev_interval = interval;
+    }
+
+    int16_t prev = 0;
+    for (size_t i = 0; i < count; i++) {
+        put_zigzag(&raw, samples[i].temperature_x10 - prev);
+        prev = samples[i].temperature_x10;
+    }
+
+    prev = 0;
+    for (size_t i = 0; i < count; i++) {
+        put_zigzag(&raw, samples[i].humidity_x10 - prev);
+        prev = samples[i].humidity_x10;
+    }
+
+    if (raw.overflow) {
+        return 0;
+    }
+
+    byte_writer_t w = { out, out_size, 0, false };
+    put_byte(&w, 'H');
+    put_byte(&w, 'B');
+    put_byte(&w, BATCH_CODEC_VERSION);
+    put_varint(&w, raw.pos);
+    if (!lz_compress(scratch, raw.pos, &w)) {
+        return 0;
+    }
+    return w.pos;
+}
+
+int batch_decode(const uint8_t *in, size_t len,
+                 uint64_t *base_time_ms, uint8_t *flags,
+                 uint8_t *scratch, size_t scratch_size,
+                 batch_sample_t *samples, size_t max_samples) {
+    byte_reader_t r = { in, len, 0, false };
+
+    if (get_byte(&r) != 'H' || get_byte(&r) != 'B' || get_byte(&r) != BATCH_CODEC_VERSION) {
+        return -1;
+    }
+    uint64_t raw_len = get_varint(&r);
+    if (r.error || raw_len > scratch_size || !lz_decompress(&r, scratch, (size_t)raw_len)) {
+        return -1;
+    }
+
+    byte_reader_t raw = { scratch, (size_t)raw_len, 0, false };
+    uint64_t count = get_varint(&raw);
+    *base_time_ms = get_varint(&raw);
+    *flags = get_byte(&raw);
+    if (raw.error || count > max_samples) {
+        return -1;
+    }
+
+    int64_t offset = 0;
+    int64_t interval = 0;
+    for (size_t i = 0; i < count; i++) {
+        interval += get_zigzag(&raw);
+        offset += interval;
+        samples[i].offset_ms = (uint32_t)offset;
+    }
+
+    int32_t value = 0;
+    for (size_t i = 0; i < count; i++) {
+        value += get_zigzag(&raw);
+        samples[i].temperature_x10 = (int16_t)value;
+    }
+
+    value = 0;
+    for (size_t i = 0; i < count; i++) {
+        value += get_zigzag(&raw);
+        samples[i].humidity_x10 = (int16_t)value;
+    }
+
+    return raw.error ? -1 : (int)count;
+}
+
+size_t batch_base64_encode(const uint8_t *in, size_t len, char *out, size_t out_size) {
+    size_t needed = (len + 2) / 3 * 4;
+    if (needed + 1 > out_size) {
+        return 0;
+    }
+
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t chunk = (uint32_t)in[i] << 16;
+        if (i + 1 < len) chunk |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) chunk |= in[i + 2];
+
+        out[o++] = base64_chars[(chunk >> 18) & 0x3F];
+        out[o++] = base64_chars[(chunk >> 12) & 0x3F];
+        out[o++] = i + 1 < len ? base64_chars[(chunk >> 6) & 0x3F] : '=';
+        out[o++] = i + 2 < len ? base64_chars[chunk & 0x3F] : '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+// Map a base64 character to its 6-bit value, or -1
+static int base64_value(char c) {
+    const char *p = memchr(base64_chars, c, 64);
+    return (c != '\0' && p != NULL) ? (int)(p - base64_chars) : -1;
+}
+
+size_t batch_base64_decode(const char *in, size_t len, uint8_t *out, size_t out_size) {
+    uint32_t chunk = 0;
+    int bits = 0;
+    size_t o = 0;
+
+    for (size_t i = 0; i < len && in[i] != '='; i++) {
+        int value = base64_value(in[i]);
+        if (value < 0) {
+            return 0;
+        }
+        chunk = (chunk << 6) | (uint32_t)value;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            if (o >= out_size) {
+                return 0;
+            }
+            out[o++] = (uint8_t)(chunk >> bits);
+        }
+    }
+    return o;
+}
@@ -0,0 +1,44 @@
+// batch_codec.h
+#ifndef BATCH_CODEC_H
+#define BATCH_CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Batch format:
+//   "HB" | version | varint raw_len | LZSS(raw)
+//   raw = varint count | varint base_time_ms | flags |
+//         count x zigzag(delta-of-delta of offset_ms) |
+//         count x zigzag(delta temperature_x10) |
+//         count x zigzag(delta humidity_x10)
+#define BATCH_CODEC_VERSION 1
+#define BATCH_FLAG_TIME_SYNCED 0x01 // base_time_ms is Unix time, else monotonic
+
+typedef struct {
+    uint32_t offset_ms; // Time since base_time_ms
+    int16_t temperature_x10;
+    int16_t humidity_x10;
+} batch_sample_t;
+
+// Upper bound of the raw (pre-LZ) size of a batch
+#define BATCH_RAW_MAX(count) (20 + (count) * 13)
+
+// Encode samples into out. Returns the encoded size or 0 if out is too small.
+// scratch must hold BATCH_RAW_MAX(count) bytes.
+size_t batch_encode(const batch_sample_t *samples, size_t count,
+                    uint64_t base_time_ms, uint8_t flags,
+                    uint8_t *scratch, size_t scratch_size,
+                    uint8_t *out, size_t out_size);
+
+// Decode a batch. Returns the sample count or -1 on malformed input.
+int batch_decode(const uint8_t *in, size_t len,
+                 uint64_t *base_time_ms, uint8_t *flags,
+                 uint8_t *scratch, size_t scratch_size,
+                 batch_sample_t *samples, size_t max_samples);
+
+// Base64 for text-only transports. Return output length, or 0 on overflow/error.
+size_t batch_base64_encode(const uint8_t *in, size_t len, char *out, size_t out_size);
+size_t batch_base64_decode(const char *in, size_t len, uint8_t *out, size_t out_size);
+
+#endif // BATCH_CODEC_H
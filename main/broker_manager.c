@@ -0,0 +1,398 @@
+#include "broker_manager.h"
+
+#define PUBACK_TRACK_SIZE 16
+
+static const char *TAG = "BROKER_MGR";
+
+// Ordered by preference; the first entry is the primary
+static const broker_config_t brokers[] = {
+    { CONFIG_BROKER_URI, CONFIG_USERNAME, CONFIG_AIO_KEY },
+    { BROKER_FALLBACK_URI, BROKER_FALLBACK_USERNAME, BROKER_FALLBACK_PASSWORD },
+};
+
+#define BROKER_SLOTS (sizeof(brokers) / sizeof(brokers[0]))
+
+typedef struct {
+    float connect_ms;
+    float puback_ms;
+    float error_rate;
+    uint32_t consecutive_failures;
+    uint32_t good_probes;
+    int64_t connect_started_us;
+} broker_health_t;
+
+static broker_health_t health[BROKER_SLOTS];
+static portMUX_TYPE health_lock = portMUX_INITIALIZER_UNLOCKED;
+static int active = 0;
+static int pending_active = -1; // Switch target until the old session is gone
+static bool disconnect_expected = false;
+static int64_t next_probe_us = 0;
+
+// Fail-back probe worker
+static TaskHandle_t probe_task = NULL;
+static StackType_t probe_stack[BROKER_PROBE_STACK];
+static StaticTask_t probe_tcb;
+static volatile bool probe_busy = false;
+static bool primary_recovered = false;
+
+// Outstanding PUBACKs of the active broker, and PUBACKs that arrived before
+// their publish call returned
+typedef struct {
+    int msg_id;
+    int64_t time_us;
+} puback_track_t;
+
+static puback_track_t pending_acks[PUBACK_TRACK_SIZE];
+static puback_track_t early_acks[PUBACK_TRACK_SIZE];
+static int pending_next = 0;
+static int early_next = 0;
+
+int broker_manager_count(void) {
+    // Unconfigured fallback entries are skipped
+    int count = 0;
+    for (size_t i = 0; i < BROKER_SLOTS; i++) {
+        if (brokers[i].uri[0] != '\0') {
+            count++;
+        }
+    }
+    return count;
+}
+
+const broker_config_t *broker_manager_active(void) {
+    return &brokers[active];
+}
+
+const broker_config_t *broker_manager_selected(void) {
+    portENTER_CRITICAL(&health_lock);
+    int index = pending_active >= 0 ? pending_active : active;
+    portEXIT_CRITICAL(&health_lock);
+    return &brokers[index];
+}
+
+void broker_manager_expect_disconnect(void) {
+    portENTER_CRITICAL(&health_lock);
+    disconnect_expected = true;
+    portEXIT_CRITICAL(&health_lock);
+}
+
+// Finish a pending switch once the old broker's session is over
+static void apply_pending_switch(void) {
+    portENTER_CRITICAL(&health_lock);
+    if (pending_active >= 0) {
+        active = pending_active;
+        pending_active = -1;
+    }
+    portEXIT_CRITICAL(&health_lock);
+}
+
+static float ewma(float current, float sample) {
+    return current + BROKER_EWMA_ALPHA * (sample - current);
+}
+
+// Combine latencies and error rate into a 0..100 score (caller holds health_lock)
+static int score_locked(int index) {
+    const broker_health_t *h = &health[index];
+    float score = 100.0f;
+
+    score -= (h->connect_ms / 100.0f > 40.0f) ? 40.0f : h->connect_ms / 100.0f; // 4 s = -40
+    score -= (h->puback_ms / 50.0f > 40.0f) ? 40.0f : h->puback_ms / 50.0f;     // 2 s = -40
+    score -= 60.0f * h->error_rate;
+    return score < 0 ? 0 : (int)score;
+}
+
+void broker_manager_get_health(int index, broker_health_info_t *info) {
+    portENTER_CRITICAL(&health_lock);
+    info->connect_ms = health[index].connect_ms;
+    info->puback_ms = health[index].puback_ms;
+    info->error_rate = health[index].error_rate;
+    info->score = score_locked(index);
+    portEXIT_CRITICAL(&health_lock);
+}
+
+// Record a success or failure outcome for a broker
+static void record_outcome(int index, bool success) {
+    portENTER_CRITICAL(&health_lock);
+    health[index].error_rate = ewma(health[index].error_rate, success ? 0.0f : 1.0f);
+    if (success) {
+        health[index].consecutive_failures = 0;
+    } else {
+        health[index].consecutive_failures++;
+    }
+    portEXIT_CRITICAL(&health_lock);
+}
+
+// Take a msg_id out of a track ring; returns its time or -1 (caller holds health_lock)
+static int64_t take_tracked(puback_track_t *ring, int msg_id) {
+    for (int i = 0; i < PUBACK_TRACK_SIZE; i++) {
+        if (ring[i].msg_id == msg_id) {
+            ring[i].msg_id = 0;
+            return ring[i].time_us;
+        }
+    }
+    return -1;
+}
+
+static void record_puback(int64_t sent_us, int64_t acked_us) {
+    health[active].puback_ms = ewma(health[active].puback_ms, (acked_us - sent_us) / 1000.0f);
+}
+
+void broker_manager_on_publish(int msg_id, int64_t sent_us) {
+    if (msg_id <= 0) {
+        return;
+    }
+    portENTER_CRITICAL(&health_lock);
+    int64_t acked_us = take_tracked(early_acks, msg_id);
+    if (acked_us >= 0) {
+        record_puback(sent_us, acked_us);
+    } else {
+        pending_acks[pending_next].msg_id = msg_id;
+        pending_acks[pending_next].time_us = sent_us;
+        pending_next = (pending_next + 1) % PUBACK_TRACK_SIZE;
+    }
+    portEXIT_CRITICAL(&health_lock);
+}
+
+// Match a PUBACK to its publish and update the latency average
+static void on_puback(int msg_id) {
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&health_lock);
+    int64_t sent_us = take_tracked(pending_acks, msg_id);
+    if (sent_us >= 0) {
+        record_puback(sent_us, now);
+    } else {
+        // The publish call has not returned yet; matched in broker_manager_on_publish
+        early_acks[early_next].msg_id = msg_id;
+        early_acks[early_next].time_us = now;
+        early_next = (early_next + 1) % PUBACK_TRACK_SIZE;
+    }
+    portEXIT_CRITICAL(&health_lock);
+}
+
+void broker_manager_on_event(esp_mqtt_event_handle_t event) {
+    switch (event->event_id) {
+        case MQTT_EVENT_BEFORE_CONNECT:
+            // The switch's disconnect may not raise an event if the session was already down
+            apply_pending_switch();
+            portENTER_CRITICAL(&health_lock);
+            disconnect_expected = false;
+            portEXIT_CRITICAL(&health_lock);
+            health[active].connect_started_us = esp_timer_get_time();
+            break;
+
+        case MQTT_EVENT_CONNECTED: {
+            float latency_ms = (esp_timer_get_time() - health[active].connect_started_us) / 1000.0f;
+            portENTER_CRITICAL(&health_lock);
+            health[active].connect_ms = ewma(health[active].connect_ms, latency_ms);
+            portEXIT_CRITICAL(&health_lock);
+            record_outcome(active, true);
+            break;
+        }
+
+        case MQTT_EVENT_DISCONNECTED: {
+            // Failed connects and dropped sessions both end here. Our own
+            // disconnects and WiFi outages say nothing about the broker.
+            portENTER_CRITICAL(&health_lock);
+            bool expected = disconnect_expected;
+            disconnect_expected = false;
+            portEXIT_CRITICAL(&health_lock);
+
+            if (!expected && net_state_is(NET_GOT_IP)) {
+                record_outcome(active, false);
+            }
+            apply_pending_switch();
+            break;
+        }
+
+        case MQTT_EVENT_PUBLISHED:
+            on_puback(event->msg_id);
+            record_outcome(active, true);
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Split "scheme://host[:port][/path]" into host and port
+static bool parse_broker_uri(const char *uri, char *host, size_t host_size, int *port) {
+    const char *sep = strstr(uri, "://");
+    if (sep == NULL) {
+        return false;
+    }
+
+    size_t scheme_len = sep - uri;
+    *port = (scheme_len == 5 && strncmp(uri, "mqtts", 5) == 0) ? 8883 :
+            (scheme_len == 3 && strncmp(uri, "wss", 3) == 0) ? 443 :
+            (scheme_len == 2 && strncmp(uri, "ws", 2) == 0) ? 80 : 1883;
+
+    const char *start = sep + 3;
+    size_t len = strcspn(start, ":/");
+    if (len == 0 || len >= host_size) {
+        return false;
+    }
+    memcpy(host, start, len);
+    host[len] = '\0';
+
+    if (start[len] == ':') {
+        *port = atoi(&start[len + 1]);
+    }
+    return true;
+}
+
+// Non-blocking TCP connect to the broker; returns latency in ms or -1
+static int probe_broker(const broker_config_t *broker) {
+    char host[64];
+    char port_str[8];
+    int port;
+    struct addrinfo hints = { .ai_family = AF_INET, .ai_socktype = SOCK_STREAM };
+    struct addrinfo *res = NULL;
+
+    if (!parse_broker_uri(broker->uri, host, sizeof(host), &port)) {
+        return -1;
+    }
+    snprintf(port_str, sizeof(port_str), "%d", port);
+
+    int64_t start = esp_timer_get_time();
+    if (getaddrinfo(host, port_str, &hints, &res) != 0 || res == NULL) {
+        return -1;
+    }
+
+    int sock = socket(res->ai_family, res->ai_socktype, 0);
+    if (sock < 0) {
+        freeaddrinfo(res);
+        return -1;
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL, 0) | O_NONBLOCK);
+
+    int result = -1;
+    if (connect(sock, res->ai_addr, res->ai_addrlen) == 0 || errno == EINPROGRESS) {
+        fd_set writable;
+        FD_ZERO(&writable);
+        FD_SET(sock, &writable);
+        struct timeval timeout = {
+            .tv_sec = BROKER_PROBE_TIMEOUT_MS / 1000,
+            .tv_usec = (BROKER_PROBE_TIMEOUT_MS % 1000) * 1000
+        };
+
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        if (select(sock + 1, NULL, &writable, NULL, &timeout) == 1 &&
+            getsockopt(sock, SOL_SOCKET, SO_ERROR, &error, &error_len) == 0 && error == 0) {
+            result = (int)((esp_timer_get_time() - start) / 1000);
+        }
+    }
+
+    close(sock);
+    freeaddrinfo(res);
+    return result;
+}
+
+// Select another broker; it becomes active once the current session ends
+static void switch_to(int index, const char *reason) {
+    ESP_LOGW(TAG, "Switching broker %s -> %s (%s)",
+             brokers[active].uri, brokers[index].uri, reason);
+
+    portENTER_CRITICAL(&health_lock);
+    pending_active = index;
+    health[index].consecutive_failures = 0;
+    health[index].good_probes = 0;
+    primary_recovered = false;
+    memset(pending_acks, 0, sizeof(pending_acks));
+    memset(early_acks, 0, sizeof(early_acks));
+    portEXIT_CRITICAL(&health_lock);
+
+    next_probe_us = esp_timer_get_time() + (int64_t)BROKER_FAILBACK_PROBE_MS * 1000;
+}
+
+// Probe worker: DNS lookup and connect can block for seconds, so they stay
+// off the MQTT task; the result is picked up by the next evaluation
+static void probe_task_main(void *param) {
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int latency_ms = probe_broker(&brokers[0]);
+
+        portENTER_CRITICAL(&health_lock);
+        if (latency_ms >= 0) {
+            health[0].connect_ms = ewma(health[0].connect_ms, latency_ms);
+            health[0].error_rate = ewma(health[0].error_rate, 0.0f);
+            health[0].good_probes++;
+        } else {
+            health[0].error_rate = ewma(health[0].error_rate, 1.0f);
+            health[0].good_probes = 0;
+        }
+        if (active != 0 && health[0].good_probes >= BROKER_FAILBACK_PROBES &&
+            score_locked(0) >= BROKER_SCORE_FAILOVER) {
+            primary_recovered = true;
+        }
+        probe_busy = false;
+        portEXIT_CRITICAL(&health_lock);
+
+        ESP_LOGD(TAG, "Primary probe: %d ms", latency_ms);
+    }
+}
+
+void broker_manager_init(void) {
+    if (broker_manager_count() < 2 || probe_task != NULL) {
+        return;
+    }
+    probe_task = xTaskCreateStatic(probe_task_main, "broker_probe", sizeof(probe_stack), NULL,
+                                   BROKER_PROBE_PRIORITY, probe_stack, &probe_tcb);
+}
+
+// Fail back once the primary has been healthy for a while, and start the next probe
+static bool try_failback(void) {
+    portENTER_CRITICAL(&health_lock);
+    bool recovered = primary_recovered;
+    primary_recovered = false;
+    portEXIT_CRITICAL(&health_lock);
+
+    if (recovered) {
+        switch_to(0, "primary recovered");
+        return true;
+    }
+
+    int64_t now = esp_timer_get_time();
+    if (probe_task == NULL || probe_busy || now < next_probe_us) {
+        return false;
+    }
+    next_probe_us = now + (int64_t)BROKER_FAILBACK_PROBE_MS * 1000;
+    probe_busy = true;
+    xTaskNotifyGive(probe_task);
+    return false;
+}
+
+bool broker_manager_evaluate(void) {
+    if (broker_manager_count() < 2) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&health_lock);
+    if (pending_active >= 0) {
+        portEXIT_CRITICAL(&health_lock);
+        return false; // Previous switch still in progress
+    }
+    int active_score = score_locked(active);
+    bool failing = health[active].consecutive_failures >= BROKER_MAX_CONNECT_FAILURES;
+    int best = -1;
+    int best_score = -1;
+    for (int i = 0; i < (int)BROKER_SLOTS; i++) {
+        int s = score_locked(i);
+        if (i != active && brokers[i].uri[0] != '\0' && s > best_score) {
+            best = i;
+            best_score = s;
+        }
+    }
+    portEXIT_CRITICAL(&health_lock);
+
+    if (best >= 0 && (failing ||
+        (active_score < BROKER_SCORE_FAILOVER && best_score >= active_score + BROKER_SCORE_HYSTERESIS))) {
+        switch_to(best, failing ? "connection failures" : "degraded");
+        return true;
+    }
+
+    if (active != 0) {
+        return try_failback();
+    }
+    return false;
+}
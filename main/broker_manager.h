@@ -0,0 +1,75 @@
+// broker_manager.h
+#ifndef BROKER_MANAGER_H
+#define BROKER_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mqtt_client.h"
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+#include "global_data.h"
+#include "net_state.h"
+
+// Health scoring (score 0..100, higher is better)
+#define BROKER_EWMA_ALPHA 0.3f
+#define BROKER_SCORE_FAILOVER 50       // Leave the active broker below this
+#define BROKER_SCORE_HYSTERESIS 15     // Candidate must be this much better
+#define BROKER_MAX_CONNECT_FAILURES 3  // Consecutive drops/failed connects before failover
+#define BROKER_RECONNECT_TIMEOUT_MS 3000 // Client retry period (default is 10 s)
+
+// Fail-back: probe the primary with a TCP connect while on a fallback broker
+#define BROKER_FAILBACK_PROBE_MS 30000
+#define BROKER_FAILBACK_PROBES 3       // Consecutive good probes before failing back
+#define BROKER_PROBE_TIMEOUT_MS 2000
+#define BROKER_PROBE_STACK 3072        // Probe worker (DNS lookup and TCP connect)
+#define BROKER_PROBE_PRIORITY 1
+#define BROKER_EVAL_INTERVAL_MS 1000
+
+typedef struct {
+    const char *uri;
+    const char *username;
+    const char *password;
+} broker_config_t;
+
+typedef struct {
+    float connect_ms; // EWMA connect latency
+    float puback_ms;  // EWMA PUBACK latency
+    float error_rate; // EWMA of failed outcomes (0..1)
+    int score;
+} broker_health_info_t;
+
+// Create the fail-back probe worker (startup, only with a fallback broker)
+void broker_manager_init(void);
+
+const broker_config_t *broker_manager_active(void);
+
+// Broker the client should be configured for; differs from the active one
+// while a switch waits for the old session's disconnect
+const broker_config_t *broker_manager_selected(void);
+
+int broker_manager_count(void);
+void broker_manager_get_health(int index, broker_health_info_t *info);
+
+// Feed MQTT events into the active broker's health
+void broker_manager_on_event(esp_mqtt_event_handle_t event);
+
+// Call before the MQTT task disconnects the client itself, so the
+// disconnect is not counted as a broker failure
+void broker_manager_expect_disconnect(void);
+
+// Record a QoS > 0 publish so its PUBACK latency can be measured; sent_us is
+// taken before the publish call, as the PUBACK may be handled before it returns
+void broker_manager_on_publish(int msg_id, int64_t sent_us);
+
+// Periodic evaluation; returns true if the active broker changed and the
+// client must be reconfigured
+bool broker_manager_evaluate(void);
+
+#endif // BROKER_MANAGER_H
@@ -0,0 +1,143 @@
+#include "buzzer.h"
+
+static const char *TAG = "BUZZER";
+
+// One pattern step: a tone (0 Hz = silence) held for duration_ms
+typedef struct {
+    uint16_t freq_hz;
+    uint16_t duration_ms;
+} buzzer_step_t;
+
+typedef struct {
+    const buzzer_step_t *steps;
+    uint8_t count; // Patterns repeat from the first step
+} buzzer_sequence_t;
+
+static const buzzer_step_t warning_steps[] = {
+    { 2000, 150 }, { 0, 2850 }
+};
+static const buzzer_step_t critical_steps[] = {
+    { 2700, 200 }, { 0, 50 }, { 2000, 200 }, { 0, 50 }
+};
+static const buzzer_step_t sensor_failure_steps[] = {
+    { 1000, 80 }, { 0, 80 }, { 1000, 80 }, { 0, 4760 }
+};
+
+static const buzzer_sequence_t sequences[BUZZER_PATTERN_COUNT] = {
+    [BUZZER_PATTERN_OFF] = { NULL, 0 },
+    [BUZZER_PATTERN_WARNING] = { warning_steps, 2 },
+    [BUZZER_PATTERN_CRITICAL] = { critical_steps, 4 },
+    [BUZZER_PATTERN_SENSOR_FAILURE] = { sensor_failure_steps, 4 },
+};
+
+static esp_timer_handle_t step_timer = NULL;
+static portMUX_TYPE request_lock = portMUX_INITIALIZER_UNLOCKED;
+static buzzer_pattern_t requested = BUZZER_PATTERN_OFF;
+
+// Sequencer state, only touched from the timer callback
+static buzzer_pattern_t playing = BUZZER_PATTERN_OFF;
+static uint8_t step = 0;
+static uint16_t current_freq = 0;
+
+// Output a tone, or silence with freq_hz 0
+static void set_tone(uint16_t freq_hz) {
+    if (freq_hz != 0 && freq_hz != current_freq) {
+        ledc_set_freq(BUZZER_LEDC_MODE, BUZZER_LEDC_TIMER, freq_hz);
+    }
+    if ((freq_hz != 0) != (current_freq != 0)) {
+        ledc_set_duty(BUZZER_LEDC_MODE, BUZZER_LEDC_CHANNEL, freq_hz ? BUZZER_LEDC_DUTY : 0);
+        ledc_update_duty(BUZZER_LEDC_MODE, BUZZER_LEDC_CHANNEL);
+    }
+    current_freq = freq_hz;
+}
+
+// Timer callback: switch to the next step (or the newly requested pattern)
+// and re-arm for its duration; the PWM itself needs no CPU
+static void step_timer_callback(void *arg) {
+    portENTER_CRITICAL(&request_lock);
+    buzzer_pattern_t next = requested;
+    portEXIT_CRITICAL(&request_lock);
+
+    if (next != playing) {
+        playing = next;
+        step = 0;
+    } else if (playing != BUZZER_PATTERN_OFF) {
+        step = (step + 1) % sequences[playing].count;
+    }
+
+    if (playing == BUZZER_PATTERN_OFF) {
+        set_tone(0);
+        return;
+    }
+
+    const buzzer_step_t *s = &sequences[playing].steps[step];
+    set_tone(s->freq_hz);
+    esp_timer_start_once(step_timer, (uint64_t)s->duration_ms * 1000);
+}
+
+void buzzer_init(void) {
+    ledc_timer_config_t timer_config = {
+        .speed_mode = BUZZER_LEDC_MODE,
+        .duty_resolution = BUZZER_LEDC_RESOLUTION,
+        .timer_num = BUZZER_LEDC_TIMER,
+        .freq_hz = BUZZER_DEFAULT_FREQ_HZ,
+        .clk_cfg = LEDC_AUTO_CLK
+    };
+    ESP_ERROR_CHECK(ledc_timer_config(&timer_config));
+
+    ledc_channel_config_t channel_config = {
+        .gpio_num = BUZZER_GPIO,
+        .speed_mode = BUZZER_LEDC_MODE,
+        .channel = BUZZER_LEDC_CHANNEL,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = BUZZER_LEDC_TIMER,
+        .duty = 0,
+        .hpoint = 0
+    };
+    ESP_ERROR_CHECK(ledc_channel_config(&channel_config));
+    current_freq = 0;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = step_timer_callback,
+        .name = "buzzer_step"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&timer_args, &step_timer));
+
+    ESP_LOGI(TAG, "Buzzer initialized on pin %d (LEDC)", BUZZER_GPIO);
+}
+
+void buzzer_play(buzzer_pattern_t pattern) {
+    if (pattern >= BUZZER_PATTERN_COUNT) {
+        return;
+    }
+
+    portENTER_CRITICAL(&request_lock);
+    bool changed = (requested != pattern);
+    requested = pattern;
+    portEXIT_CRITICAL(&request_lock);
+
+    if (!changed) {
+        return;
+    }
+    ESP_LOGI(TAG, "Pattern: %s", buzzer_pattern_name(pattern));
+
+    // Cut the current step short (the callback may have re-armed the timer
+    // concurrently, in which case stop it again)
+    esp_timer_stop(step_timer);
+    while (esp_timer_start_once(step_timer, 0) == ESP_ERR_INVALID_STATE) {
+        esp_timer_stop(step_timer);
+    }
+}
+
+const char *buzzer_pattern_name(buzzer_pattern_t pattern) {
+    switch (pattern) {
+        case BUZZER_PATTERN_WARNING:
+            return "warning";
+        case BUZZER_PATTERN_CRITICAL:
+            return "critical";
+        case BUZZER_PATTERN_SENSOR_FAILURE:
+            return "sensor failure";
+        default:
+            return "off";
+    }
+}
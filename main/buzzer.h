@@ -0,0 +1,39 @@
+// buzzer.h
+#ifndef BUZZER_H
+#define BUZZER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "driver/ledc.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "static_mem.h"
+#include "global_data.h"
+
+// LEDC channel driving BUZZER_GPIO (50% duty square wave)
+#define BUZZER_LEDC_MODE LEDC_LOW_SPEED_MODE
+#define BUZZER_LEDC_TIMER LEDC_TIMER_0
+#define BUZZER_LEDC_CHANNEL LEDC_CHANNEL_0
+#define BUZZER_LEDC_RESOLUTION LEDC_TIMER_10_BIT
+#define BUZZER_LEDC_DUTY 512
+#define BUZZER_DEFAULT_FREQ_HZ 2000
+
+typedef enum {
+    BUZZER_PATTERN_OFF = 0,
+    BUZZER_PATTERN_WARNING,        // Short chirp every 3 s
+    BUZZER_PATTERN_CRITICAL,       // Continuous fast two-tone beeping
+    BUZZER_PATTERN_SENSOR_FAILURE, // Double low beep every 5 s
+    BUZZER_PATTERN_COUNT
+} buzzer_pattern_t;
+
+// Configure LEDC and the sequencer timer (buzzer silent)
+void buzzer_init(void);
+
+// Start a pattern from its first step (no-op if it is already playing);
+// safe from any task, playback runs from esp_timer callbacks only
+void buzzer_play(buzzer_pattern_t pattern);
+
+const char *buzzer_pattern_name(buzzer_pattern_t pattern);
+
+#endif // BUZZER_H
@@ -0,0 +1,356 @@
+#include "console_task.h"
+
+static const char *TAG = "CONSOLE";
+
+// wifi_add <ssid> [password] [priority]
+static int cmd_wifi_add(int argc, char **argv) {
+    if (argc < 2 || argc > 4) {
+        printf("Usage: wifi_add <ssid> [password] [priority]\n");
+        return 1;
+    }
+    const char *pass = (argc >= 3) ? argv[2] : "";
+    int priority = (argc == 4) ? atoi(argv[3]) : WIFI_DEFAULT_PRIORITY;
+    if (priority < 0 || priority > 255) {
+        printf("Priority must be 0..255\n");
+        return 1;
+    }
+
+    esp_err_t err = wifi_config_add_network(argv[1], pass, (uint8_t)priority);
+    if (err != ESP_OK) {
+        printf("Failed to add network: %s\n", esp_err_to_name(err));
+        return 1;
+    }
+    return 0;
+}
+
+static int cmd_wifi_forget(int argc, char **argv) {
+    esp_err_t err = wifi_config_forget_networks();
+    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
+        printf("Failed to erase networks: %s\n", esp_err_to_name(err));
+        return 1;
+    }
+    printf("Stored networks erased\n");
+    return 0;
+}
+
+// wifi_static <ip> <netmask> <gateway> [dns] | wifi_static off
+static int cmd_wifi_static(int argc, char **argv) {
+    wifi_static_ip_t cfg = {0};
+
+    if (argc == 2 && strcmp(argv[1], "off") == 0) {
+        return ip_config_set_static(NULL) == ESP_OK ? 0 : 1;
+    }
+    if (argc < 4 || argc > 5 ||
+        esp_netif_str_to_ip4(argv[1], &cfg.info.ip) != ESP_OK ||
+        esp_netif_str_to_ip4(argv[2], &cfg.info.netmask) != ESP_OK ||
+        esp_netif_str_to_ip4(argv[3], &cfg.info.gw) != ESP_OK ||
+        (argc == 5 && esp_netif_str_to_ip4(argv[4], &cfg.dns) != ESP_OK)) {
+        printf("Usage: wifi_static <ip> <netmask> <gateway> [dns] | wifi_static off\n");
+        return 1;
+    }
+
+    if (ip_config_set_static(&cfg) != ESP_OK) {
+        printf("Failed to save static IP\n");
+        return 1;
+    }
+    printf("Static IP saved, applied on the next association (see 'reconnect')\n");
+    return 0;
+}
+
+static int cmd_reconnect(int argc, char **argv) {
+    wifi_config_reconnect();
+    return 0;
+}
+
+// interval <ms>
+static int cmd_interval(int argc, char **argv) {
+    if (argc != 2) {
+        printf("Publish interval: %u ms\n", mqtt_publish_interval_ms);
+        return 0;
+    }
+
+    long interval_ms = strtol(argv[1], NULL, 10);
+    if (interval_ms < MQTT_PUBLISH_DELAY_MIN || interval_ms > MQTT_PUBLISH_DELAY_MAX) {
+        printf("Interval must be %d..%d ms\n", MQTT_PUBLISH_DELAY_MIN, MQTT_PUBLISH_DELAY_MAX);
+        return 1;
+    }
+    mqtt_publish_interval_ms = (uint32_t)interval_ms;
+    ESP_LOGI(TAG, "Publish interval set to: %u ms", mqtt_publish_interval_ms);
+    return 0;
+}
+
+// Whole-argument number parsers (no trailing text, no NaN or infinity)
+static bool parse_float_arg(const char *arg, float *out) {
+    char *end;
+    *out = strtof(arg, &end);
+    return end != arg && *end == '\0' && isfinite(*out);
+}
+
+static bool parse_u32_arg(const char *arg, uint32_t *out) {
+    char *end;
+    unsigned long long value = strtoull(arg, &end, 10);
+    *out = (uint32_t)value;
+    return end != arg && *end == '\0' && arg[0] != '-' && value <= UINT32_MAX;
+}
+
+// alarm [warning critical [hysteresis [warning_hold_ms critical_hold_ms [horizon_s]]]]
+static int cmd_alarm(int argc, char **argv) {
+    alarm_config_t cfg;
+    alarm_monitor_get_config(&cfg);
+
+    if (argc == 1) {
+        printf("Alarm: %s%s | warning %.1f C (%u ms), critical %.1f C (%u ms), hysteresis %.1f C, "
+               "pre-alarm horizon %u s\n",
+               alarm_level_name(alarm_monitor_level()), alarm_monitor_prealarm() ? " (pre-alarm)" : "",
+               cfg.warning_c, cfg.warning_hold_ms, cfg.critical_c, cfg.critical_hold_ms,
+               cfg.hysteresis_c, cfg.prealarm_horizon_s);
+        return 0;
+    }
+    if (argc != 3 && argc != 4 && argc != 6 && argc != 7) {
+        printf("Usage: alarm [warning critical [hysteresis [warning_hold_ms critical_hold_ms [horizon_s]]]]\n");
+        return 1;
+    }
+
+    if (!parse_float_arg(argv[1], &cfg.warning_c) || !parse_float_arg(argv[2], &cfg.critical_c) ||
+        (argc >= 4 && !parse_float_arg(argv[3], &cfg.hysteresis_c)) ||
+        (argc >= 6 && (!parse_u32_arg(argv[4], &cfg.warning_hold_ms) ||
+                       !parse_u32_arg(argv[5], &cfg.critical_hold_ms))) ||
+        (argc == 7 && !parse_u32_arg(argv[6], &cfg.prealarm_horizon_s))) {
+        printf("Invalid number\n");
+        return 1;
+    }
+
+    esp_err_t err = alarm_monitor_set_config(&cfg);
+    if (err != ESP_OK) {
+        printf("Failed to set alarm thresholds: %s\n", esp_err_to_name(err));
+        return 1;
+    }
+    return 0;
+}
+
+// rules ["<table>"]  (quoted; "" restores the default table)
+static int cmd_rules(int argc, char **argv) {
+    if (argc == 2) {
+        esp_err_t err = sensor_rules_set_table(argv[1], strlen(argv[1]));
+        if (err != ESP_OK) {
+            printf("Failed to set rules: %s\n", esp_err_to_name(err));
+            return 1;
+        }
+    } else if (argc != 1) {
+        printf("Usage: rules [\"<table>\"]\n");
+        return 1;
+    }
+
+    char text[64];
+    bool active;
+    for (size_t i = 0; sensor_rules_get(i, text, sizeof(text), &active); i++) {
+        printf("  [%u] %s%s\n", (unsigned)i, text, active ? "  (firing)" : "");
+    }
+    return 0;
+}
+
+// schedule [<command words>]  (see action_scheduler.h); lists entries
+static int cmd_schedule(int argc, char **argv) {
+    if (argc > 1) {
+        char text[SCHEDULE_COMMAND_MAX];
+        size_t used = 0;
+
+        for (int i = 1; i < argc && used < sizeof(text); i++) {
+            used += snprintf(text + used, sizeof(text) - used, "%s%s", i > 1 ? " " : "", argv[i]);
+        }
+        int id = (used < sizeof(text)) ? action_scheduler_command(text, used) : -1;
+        if (id < 0) {
+            printf("Usage: schedule <actuator> <on|off> [in <dur> | at HH:MM [daily]] [for <dur>]"
+                   " | cancel <id> | clear\n");
+            return 1;
+        }
+    }
+
+    char text[64];
+    printf("%u scheduled\n", (unsigned)action_scheduler_count());
+    for (int id = 0; id < SCHEDULE_MAX; id++) {
+        if (action_scheduler_describe(id, text, sizeof(text))) {
+            printf("  [%d] %s\n", id, text);
+        }
+    }
+    return 0;
+}
+
+// Task placement and the sensor read failure rate it is meant to keep low
+static int cmd_tasks(int argc, char **argv) {
+    dht11_stats_t dht;
+
+    for (int i = 0; i < TASK_PLAN_COUNT; i++) {
+        const task_plan_entry_t *task = task_plan_get(i);
+        printf("  %-16s core %-3s priority %2u, stack %5u%s\n", task->name,
+               task->core == tskNO_AFFINITY ? "any" : (task->core ? "1" : "0"),
+               (unsigned)task->priority, (unsigned)task->stack_size,
+               task_plan_handle(i) ? "" : "  (not running)");
+    }
+
+    dht11_get_stats(&dht);
+    printf("DHT11: %u reads, %u failed (%u timeouts), %.1f%% failure rate\n",
+           dht.reads, dht.failures, dht.timeouts,
+           dht.reads ? dht.failures * 100.0 / dht.reads : 0.0);
+    return 0;
+}
+
+// Stack headroom of every task and heap per capability
+static int cmd_health(int argc, char **argv) {
+    health_report_t report;
+
+    health_sample(&report);
+    for (int i = 0; i < HEALTH_TASK_COUNT; i++) {
+        const health_task_t *task = &report.tasks[i];
+        if (task->stack_free < 0) {
+            printf("  %-16s not running\n", task->name);
+            continue;
+        }
+        printf("  %-16s stack %5d bytes free", task->name, (int)task->stack_free);
+        if (task->stack_size) {
+            printf(" of %5u", (unsigned)task->stack_size);
+        }
+        printf("%s\n", (report.warnings & (1u << i)) ? "  LOW" : "");
+    }
+    for (int i = 0; i < HEALTH_HEAP_COUNT; i++) {
+        const health_heap_t *heap = &report.heaps[i];
+        printf("Heap %-8s %7u free, %7u minimum, %7u largest block\n", heap->name,
+               (unsigned)heap->free, (unsigned)heap->min_free, (unsigned)heap->largest_block);
+    }
+    if (report.warnings & (HEALTH_WARN_HEAP_FREE | HEALTH_WARN_HEAP_BLOCK)) {
+        printf("Internal heap below its warning level (%d free / %d block)\n",
+               HEALTH_HEAP_WARN_BYTES, HEALTH_BLOCK_WARN_BYTES);
+    }
+    return 0;
+}
+
+static void print_permille(uint16_t value) {
+    printf(" %3u.%u%%", value / 10, value % 10);
+}
+
+// CPU use per core and task over both windows, then hot section timings
+static int cmd_cpu(int argc, char **argv) {
+    static profiler_cpu_t cpu;
+    profiler_section_stats_t sections[PROFILER_SECTION_COUNT];
+
+    profiler_get_cpu(&cpu);
+    profiler_get_sections(sections);
+
+    printf("Window            %6us %6us\n", (unsigned)(cpu.window_ms[0] / 1000),
+           (unsigned)(cpu.window_ms[1] / 1000));
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        printf("Core %d busy      ", core);
+        print_permille(cpu.core_busy_permille[core][0]);
+        print_permille(cpu.core_busy_permille[core][1]);
+        printf("\n");
+    }
+    for (size_t i = 0; i < cpu.task_count; i++) {
+        const profiler_task_usage_t *task = &cpu.tasks[i];
+        if (task->core < 0) {
+            printf("  %-16s any", task->name);
+        } else {
+            printf("  %-16s %3d", task->name, task->core);
+        }
+        print_permille(task->permille[0]);
+        print_permille(task->permille[1]);
+        printf("\n");
+    }
+
+    printf("Section (us)     count    min    avg    max    p99\n");
+    for (int i = 0; i < PROFILER_SECTION_COUNT; i++) {
+        const profiler_section_stats_t *s = &sections[i];
+        printf("  %-12s %8u %6u %6u %6u %6u\n", s->name, (unsigned)s->count,
+               (unsigned)s->min_us, (unsigned)s->avg_us, (unsigned)s->max_us, (unsigned)s->p99_us);
+    }
+    return 0;
+}
+
+// Print the live counters of every subsystem
+static int cmd_stats(int argc, char **argv) {
+    wifi_reconnect_stats_t wifi;
+    ip_config_timing_t ip;
+    power_save_stats_t power;
+    publish_scheduler_stats_t publish;
+    mqtt_tls_stats_t tls;
+
+    wifi_reconnect_get_stats(&wifi);
+    ip_config_get_timing(&ip);
+    power_save_get_stats(&power);
+    publish_scheduler_get_stats(&publish);
+    mqtt_tls_get_stats(&tls);
+
+    printf("Sensor:  %.1f C, %.1f %%, alarm %s, interval %u ms\n", temperature, humidity,
+           alarm_level_name(alarm_monitor_level()), mqtt_publish_interval_ms);
+    printf("Outputs: actuators 0x%08x of 0x%08x\n", actuator_state(), actuator_all_mask());
+    printf("Network: link %d, ip %d, broker %d\n", net_state_is(NET_LINK_UP),
+           net_state_is(NET_GOT_IP), net_state_is(NET_BROKER_UP));
+    printf("WiFi:    %u disconnects, %u reconnect attempts, %u roams, outage last %u ms / max %u ms / total %llu ms\n",
+           wifi.disconnects, wifi.reconnect_attempts, wifi.roams, wifi.last_outage_ms,
+           wifi.max_outage_ms, (unsigned long long)wifi.total_outage_ms);
+    printf("IP:      %s, assoc->IP last %u ms (min %u, max %u, %u samples)\n",
+           ip_config_mode_name(ip.mode), ip.last_ms, ip.min_ms, ip.max_ms, ip.samples);
+    printf("Power:   offline %llu ms, active %llu ms, modem sleep %llu ms, %u wakes, ~%.1f mA\n",
+           (unsigned long long)power.time_ms[POWER_STATE_OFFLINE],
+           (unsigned long long)power.time_ms[POWER_STATE_ACTIVE],
+           (unsigned long long)power.time_ms[POWER_STATE_MODEM_SLEEP],
+           power.tx_windows, power.avg_current_ma);
+    printf("Publish: %u sent, %u coalesced, %u dropped, %u throttled, %u failed\n",
+           publish.sent, publish.coalesced, publish.dropped, publish.throttled, publish.failed);
+    printf("TLS:     %u connects, %u failures, last connect %u ms\n",
+           tls.connects, tls.failures, tls.last_ms);
+
+    printf("Broker:  %s\n", broker_manager_active()->uri);
+    for (int i = 0; i < broker_manager_count(); i++) {
+        broker_health_info_t health;
+        broker_manager_get_health(i, &health);
+        printf("  [%d] score %d, connect %.0f ms, puback %.0f ms, errors %.2f\n",
+               i, health.score, health.connect_ms, health.puback_ms, health.error_rate);
+    }
+    return 0;
+}
+
+static const esp_console_cmd_t commands[] = {
+    { .command = "wifi_add", .help = "Add or update a known network",
+      .hint = "<ssid> [password] [priority]", .func = cmd_wifi_add },
+    { .command = "wifi_forget", .help = "Erase all stored networks", .func = cmd_wifi_forget },
+    { .command = "wifi_static", .help = "Set static addressing or switch back to DHCP",
+      .hint = "<ip> <netmask> <gateway> [dns] | off", .func = cmd_wifi_static },
+    { .command = "reconnect", .help = "Drop the WiFi link and reconnect", .func = cmd_reconnect },
+    { .command = "interval", .help = "Show or set the telemetry interval",
+      .hint = "[ms]", .func = cmd_interval },
+    { .command = "alarm", .help = "Show or set the alarm thresholds (stored in NVS)",
+      .hint = "[warning critical [hysteresis [warning_hold_ms critical_hold_ms [horizon_s]]]]",
+      .func = cmd_alarm },
+    { .command = "rules", .help = "Show or replace the sensor rule table (stored in NVS)",
+      .hint = "[\"<table>\"]", .func = cmd_rules },
+    { .command = "schedule", .help = "Show, add or cancel timed actuator actions (stored in NVS)",
+      .hint = "[<actuator> <on|off> [in <dur> | at HH:MM [daily]] [for <dur>] | cancel <id> | clear]",
+      .func = cmd_schedule },
+    { .command = "tasks", .help = "Show the task placement plan and sensor read failures",
+      .func = cmd_tasks },
+    { .command = "health", .help = "Show stack headroom per task and heap per capability",
+      .func = cmd_health },
+    { .command = "cpu", .help = "Show CPU use per core and task, and hot section timings",
+      .func = cmd_cpu },
+    { .command = "stats", .help = "Show live statistics", .func = cmd_stats },
+};
+
+void console_start(void) {
+    esp_console_repl_t *repl = NULL;
+    esp_console_repl_config_t repl_config = ESP_CONSOLE_REPL_CONFIG_DEFAULT();
+    esp_console_dev_uart_config_t uart_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
+
+    repl_config.prompt = CONSOLE_PROMPT;
+    repl_config.task_priority = CONSOLE_TASK_PRIORITY;
+    repl_config.task_stack_size = CONSOLE_TASK_STACK_SIZE;
+    uart_config.channel = UART_NUM;
+
+    // Creating the REPL initialises esp_console, so commands come after
+    ESP_ERROR_CHECK(esp_console_new_repl_uart(&uart_config, &repl_config, &repl));
+    ESP_ERROR_CHECK(esp_console_register_help_command());
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        ESP_ERROR_CHECK(esp_console_cmd_register(&commands[i]));
+    }
+    ESP_ERROR_CHECK(esp_console_start_repl(repl));
+    ESP_LOGI(TAG, "Console ready, type 'help' for commands");
+}
@@ -0,0 +1,30 @@
+// console_task.h
+#ifndef CONSOLE_TASK_H
+#define CONSOLE_TASK_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_console.h"
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "global_data.h"
+#include "wifi_config.h"
+#include "mqtt_task.h"
+#include "alarm_monitor.h"
+#include "sensor_rules.h"
+#include "action_scheduler.h"
+#include "task_plan.h"
+#include "health.h"
+#include "profiler.h"
+
+#define CONSOLE_TASK_PRIORITY 2
+#define CONSOLE_TASK_STACK_SIZE 4096
+#define CONSOLE_PROMPT "tepbac> "
+
+// Start the serial REPL in its own task (never blocks the caller)
+void console_start(void);
+
+#endif // CONSOLE_TASK_H
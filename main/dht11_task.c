@@ -8,6 +8,36 @@
 #define DHT_DATA_BITS 40
 #define DHT_BYTES 5
 
+static sensor_listener_t listeners[DHT11_MAX_LISTENERS];
+static int listener_count = 0;
+static dht11_stats_t stats;
+
+bool dht11_register_listener(sensor_listener_t listener) {
+    if (listener_count >= DHT11_MAX_LISTENERS) {
+        return false;
+    }
+    listeners[listener_count++] = listener;
+    return true;
+}
+
+// Deliver a reading to all registered listeners
+static void notify_listeners(bool valid) {
+    sensor_sample_t sample = {
+        .timestamp_us = esp_timer_get_time(),
+        .temperature = temperature,
+        .humidity = humidity,
+        .valid = valid
+    };
+
+    for (int i = 0; i < listener_count; i++) {
+        listeners[i](&sample);
+    }
+}
+
+void dht11_get_stats(dht11_stats_t *out) {
+    *out = stats;
+}
+
 // Wait for pin to reach specified state with timeout
 static int wait_for_state(int pin, int state, int timeout_us) {
     int count = 0;
@@ -30,6 +60,7 @@ static void send_start_signal(int pin, int duration_us) {
 
 // Read data from DHT11 sensor
 static int dht11_read_data(int pin) {
+    PROFILER_SCOPE(PROFILER_SECTION_DHT_READ);
     uint8_t data[DHT_BYTES] = {0};
 
     // Send start signal
@@ -44,12 +75,14 @@ static int dht11_read_data(int pin) {
         for (int bit_index = 0; bit_index < 8; bit_index++) {
             // Wait for bit start (high state)
             if (wait_for_state(pin, 1, DHT_TIMEOUT_US) == -1) {
+                stats.timeouts++;
                 return -1;
             }
             
             // Measure high duration to determine bit value
             int duration = wait_for_state(pin, 0, DHT_TIMEOUT_US);
             if (duration == -1) {
+                stats.timeouts++;
                 return -1;
             }
             
@@ -84,16 +117,22 @@ static void dht11_init(int pin) {
 void dht11_task(void *pvParameters) {
     dht11_init(DHT11_GPIO);
 
+    const uint32_t read_delay = HISTORY_BATCH_ENABLE ? HISTORY_SAMPLE_DELAY : DHT11_READ_DELAY;
+
     while (1) {
+        stats.reads++;
         if (dht11_read_data(DHT11_GPIO) == 0) {
             ESP_LOGI(DHT_LOG_TAG, "Temperature: %.1f°C | Humidity: %.1f%%", 
                      temperature, humidity);
+            notify_listeners(true);
         } else {
             ESP_LOGW(DHT_LOG_TAG, "Failed to read DHT11 sensor");
+            stats.failures++;
             temperature = -99.0f;
             humidity = -99.0f;
+            notify_listeners(false);
         }
 
-        vTaskDelay(pdMS_TO_TICKS(DHT11_READ_DELAY));
+        vTaskDelay(pdMS_TO_TICKS(read_delay));
     }
 }
\ No newline at end of file
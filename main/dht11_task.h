@@ -8,9 +8,35 @@
 #include "driver/gpio.h"
 #include "rom/ets_sys.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "profiler.h"
 #include <stdio.h>
 #include <string.h>
 
+#define DHT11_MAX_LISTENERS 4
+
+// One sensor reading, delivered to listeners after every read attempt
+typedef struct {
+    int64_t timestamp_us; // esp_timer time of the reading
+    float temperature;
+    float humidity;
+    bool valid;
+} sensor_sample_t;
+
+typedef void (*sensor_listener_t)(const sensor_sample_t *sample);
+
+// Read attempts since boot (timeouts and checksum errors count as failures)
+typedef struct {
+    uint32_t reads;
+    uint32_t failures;
+    uint32_t timeouts;
+} dht11_stats_t;
+
+// Register a sample listener (call before the DHT11 task starts)
+bool dht11_register_listener(sensor_listener_t listener);
+
+void dht11_get_stats(dht11_stats_t *out);
+
 void dht11_task(void *pvParameters);
 
 #endif // DHT11_TASK_H
\ No newline at end of file
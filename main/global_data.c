@@ -5,10 +5,8 @@
 float temperature = 0.0f;
 float humidity = 0.0f;
 
-// LED states
-bool led1_state = false;
-bool led2_state = false;
+// Runtime settings
+uint32_t mqtt_publish_interval_ms = MQTT_PUBLISH_DELAY;
 
 // System states
-bool wifi_connected = false;
 bool overheat_alarm = false;
\ No newline at end of file
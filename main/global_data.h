@@ -2,20 +2,19 @@
 #define GLOBAL_DATA_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 // Sensor data
 extern float temperature;
 extern float humidity;
 
-// LED states
-extern bool led1_state;
-extern bool led2_state;
-
 // System states
-extern bool wifi_connected;
 extern bool overheat_alarm;
 
-// Temperature threshold for alarm
+// Runtime settings (defaults below, changed by MQTT commands)
+extern uint32_t mqtt_publish_interval_ms;
+
+// Critical temperature for the alarm (default, see alarm_monitor.h)
 #define TEMPERATURE_THRESHOLD 40.0f
 
 // GPIO pin definitions
@@ -36,10 +35,59 @@ extern bool overheat_alarm;
 #define WIFI_PASS_MAX_LEN 64
 #define UART_NUM UART_NUM_0
 
+// Addressing: empty WIFI_STATIC_IP uses DHCP (NVS settings take precedence)
+#define WIFI_STATIC_IP ""
+#define WIFI_STATIC_NETMASK "255.255.255.0"
+#define WIFI_STATIC_GATEWAY ""
+#define WIFI_STATIC_DNS ""
+
+// JSON command feed
+#define FEED_COMMAND CONFIG_USERNAME "/feeds/command"
+
+// Rule engine: table upload (plain text, see rule_engine.h) and alert output
+#define FEED_RULES CONFIG_USERNAME "/feeds/rules"
+#define FEED_ALERTS CONFIG_USERNAME "/feeds/alerts"
+
+// Actual actuator states (JSON bitmask, retained), published after each change
+#define FEED_ACTUATORS CONFIG_USERNAME "/feeds/actuators"
+
+// Timed actuator actions (plain text, see action_scheduler.h)
+#define FEED_SCHEDULE CONFIG_USERNAME "/feeds/schedule"
+
+// Stack high-water marks and heap per capability (JSON, see health.h)
+#define FEED_HEALTH CONFIG_USERNAME "/feeds/health"
+
+// CPU use per core and task, hot section timings (JSON, see profiler.h)
+#define FEED_CPU CONFIG_USERNAME "/feeds/cpu"
+
+// Alarm events (level changes, sensor failure), QoS 1 ahead of telemetry
+#define FEED_ALARM CONFIG_USERNAME "/feeds/alarm"
+
+// MQTT fast resume: persistent session, stable client id, actuator state
+// fetched from the broker (Adafruit IO "<feed>/get") right after connecting
+#define MQTT_FAST_RESUME 1
+#define MQTT_GET_SUFFIX "/get"
+#define FEED_STATUS CONFIG_USERNAME "/feeds/status" // Retained online/offline (LWT)
+
+// Fallback broker for failover (empty URI = single broker)
+#define BROKER_FALLBACK_URI ""
+#define BROKER_FALLBACK_USERNAME ""
+#define BROKER_FALLBACK_PASSWORD ""
+
+// History batch upload (lab mode: 1 s sampling, uploaded as compressed batches)
+#define HISTORY_BATCH_ENABLE 0
+#define HISTORY_SAMPLE_DELAY 1000
+#define HISTORY_BATCH_SAMPLES 60
+#define FEED_HISTORY CONFIG_USERNAME "/feeds/history"
+
+// Time synchronization
+#define SNTP_SERVER "pool.ntp.org"
+
 // Task delays (in milliseconds)
 #define DHT11_READ_DELAY 2000
 #define MQTT_PUBLISH_DELAY 10000
-#define ALARM_CHECK_DELAY 500
+#define MQTT_PUBLISH_DELAY_MIN 2000
+#define MQTT_PUBLISH_DELAY_MAX 3600000
 #define OLED_UPDATE_DELAY 1000
 
 #endif // GLOBAL_DATA_H
\ No newline at end of file
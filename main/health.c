@@ -0,0 +1,137 @@
+#include "health.h"
+
+static const char *TAG = "HEALTH";
+
+// Looked up by name on every sample, so only tasks that are never deleted:
+// the esp-mqtt task lives as long as the client (paused, never stopped)
+static const char *const system_tasks[HEALTH_SYSTEM_TASK_COUNT] = {
+    "esp_timer", "console_repl", "mqtt_task", "tiT", "sys_evt"
+};
+
+static const struct {
+    const char *name;
+    uint32_t caps;
+} heap_types[HEALTH_HEAP_COUNT] = {
+    [HEALTH_HEAP_INTERNAL] = { "internal", MALLOC_CAP_INTERNAL },
+    [HEALTH_HEAP_DMA] = { "dma", MALLOC_CAP_DMA },
+    [HEALTH_HEAP_SPIRAM] = { "spiram", MALLOC_CAP_SPIRAM },
+};
+
+static esp_timer_handle_t sample_timer = NULL;
+static uint32_t active_warnings = 0;
+static int samples_since_publish = 0;
+
+// High-water marks are in bytes on ESP-IDF (StackType_t is one byte)
+static int32_t stack_free(TaskHandle_t handle) {
+    return handle ? (int32_t)uxTaskGetStackHighWaterMark(handle) : -1;
+}
+
+void health_sample(health_report_t *out) {
+    int n = 0;
+
+    out->warnings = 0;
+    for (int i = 0; i < TASK_PLAN_COUNT; i++, n++) {
+        out->tasks[n].name = task_plan_get(i)->name;
+        out->tasks[n].stack_size = task_plan_get(i)->stack_size;
+        out->tasks[n].stack_free = task_plan_stack_free(i);
+    }
+    for (int i = 0; i < HEALTH_SYSTEM_TASK_COUNT; i++, n++) {
+        out->tasks[n].name = system_tasks[i];
+        out->tasks[n].stack_size = 0;
+        out->tasks[n].stack_free = stack_free(xTaskGetHandle(system_tasks[i]));
+    }
+    for (n = 0; n < HEALTH_TASK_COUNT; n++) {
+        if (out->tasks[n].stack_free >= 0 && out->tasks[n].stack_free < HEALTH_STACK_WARN_BYTES) {
+            out->warnings |= 1u << n;
+        }
+    }
+
+    for (int i = 0; i < HEALTH_HEAP_COUNT; i++) {
+        multi_heap_info_t info;
+        heap_caps_get_info(&info, heap_types[i].caps);
+        out->heaps[i] = (health_heap_t) {
+            .name = heap_types[i].name,
+            .free = info.total_free_bytes,
+            .min_free = info.minimum_free_bytes,
+            .largest_block = info.largest_free_block
+        };
+    }
+    if (out->heaps[HEALTH_HEAP_INTERNAL].free < HEALTH_HEAP_WARN_BYTES) {
+        out->warnings |= HEALTH_WARN_HEAP_FREE;
+    }
+    if (out->heaps[HEALTH_HEAP_INTERNAL].largest_block < HEALTH_BLOCK_WARN_BYTES) {
+        out->warnings |= HEALTH_WARN_HEAP_BLOCK;
+    }
+}
+
+// Log warnings that appeared or cleared since the last sample
+static void log_changes(const health_report_t *report, uint32_t raised, uint32_t cleared) {
+    const health_heap_t *internal = &report->heaps[HEALTH_HEAP_INTERNAL];
+
+    for (int i = 0; i < HEALTH_TASK_COUNT; i++) {
+        if (raised & (1u << i)) {
+            ESP_LOGW(TAG, "Stack of %s down to %d bytes free", report->tasks[i].name,
+                     (int)report->tasks[i].stack_free);
+        }
+    }
+    if (raised & HEALTH_WARN_HEAP_FREE) {
+        ESP_LOGW(TAG, "Internal heap low: %u bytes free", (unsigned)internal->free);
+    }
+    if (raised & HEALTH_WARN_HEAP_BLOCK) {
+        ESP_LOGW(TAG, "Internal heap fragmented: largest block %u bytes",
+                 (unsigned)internal->largest_block);
+    }
+    if (cleared & (HEALTH_WARN_HEAP_FREE | HEALTH_WARN_HEAP_BLOCK)) {
+        ESP_LOGI(TAG, "Internal heap recovered: %u free, largest block %u",
+                 (unsigned)internal->free, (unsigned)internal->largest_block);
+    }
+}
+
+// Compact report: stacks in report order, heaps as [free,min,largest]
+static void publish_report(const health_report_t *report, publish_priority_t prio) {
+    char payload[PUBLISH_PAYLOAD_MAX];
+    int len = snprintf(payload, sizeof(payload), "{\"stack\":[");
+
+    for (int i = 0; i < HEALTH_TASK_COUNT; i++) {
+        len += snprintf(payload + len, sizeof(payload) - len, "%s%d", i ? "," : "",
+                        (int)report->tasks[i].stack_free);
+    }
+    len += snprintf(payload + len, sizeof(payload) - len, "],\"heap\":[");
+    for (int i = 0; i < HEALTH_HEAP_COUNT; i++) {
+        const health_heap_t *heap = &report->heaps[i];
+        len += snprintf(payload + len, sizeof(payload) - len, "%s[%u,%u,%u]", i ? "," : "",
+                        (unsigned)heap->free, (unsigned)heap->min_free,
+                        (unsigned)heap->largest_block);
+    }
+    len += snprintf(payload + len, sizeof(payload) - len, "],\"warn\":%u}",
+                    (unsigned)report->warnings);
+
+    publish_scheduler_submit(FEED_HEALTH, payload, len, prio == PUBLISH_PRIO_STATE ? 1 : 0, 0, prio);
+}
+
+static void sample_timer_callback(void *arg) {
+    static health_report_t report;
+
+    health_sample(&report);
+    uint32_t raised = report.warnings & ~active_warnings;
+    uint32_t cleared = active_warnings & ~report.warnings;
+    active_warnings = report.warnings;
+    log_changes(&report, raised, cleared);
+
+    if (raised) {
+        publish_report(&report, PUBLISH_PRIO_STATE);
+        samples_since_publish = 0;
+    } else if (++samples_since_publish >= HEALTH_PUBLISH_MS / HEALTH_SAMPLE_MS) {
+        publish_report(&report, PUBLISH_PRIO_TELEMETRY);
+        samples_since_publish = 0;
+    }
+}
+
+void health_init(void) {
+    const esp_timer_create_args_t timer_args = {
+        .callback = sample_timer_callback,
+        .name = "health"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&timer_args, &sample_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(sample_timer, HEALTH_SAMPLE_MS * 1000));
+}
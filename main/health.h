@@ -0,0 +1,66 @@
+// health.h
+#ifndef HEALTH_H
+#define HEALTH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "global_data.h"
+#include "task_plan.h"
+#include "publish_scheduler.h"
+#include "static_mem.h"
+
+#define HEALTH_SAMPLE_MS 10000
+#define HEALTH_PUBLISH_MS 60000 // Periodic report on FEED_HEALTH (at once on a new warning)
+
+// Warning levels, set well above the point of failure
+#define HEALTH_STACK_WARN_BYTES 512     // Least free stack a task has had
+#define HEALTH_HEAP_WARN_BYTES 24576    // Free internal heap
+#define HEALTH_BLOCK_WARN_BYTES 16384   // Largest internal block (a TLS handshake needs ~16 KB)
+
+// ESP-IDF tasks watched besides the placement plan, found by name
+#define HEALTH_SYSTEM_TASK_COUNT 5
+#define HEALTH_TASK_COUNT (TASK_PLAN_COUNT + HEALTH_SYSTEM_TASK_COUNT)
+
+typedef enum {
+    HEALTH_HEAP_INTERNAL = 0,
+    HEALTH_HEAP_DMA,
+    HEALTH_HEAP_SPIRAM,
+    HEALTH_HEAP_COUNT
+} health_heap_id_t;
+
+// Warning bits: one per task (report order), then the heap checks
+#define HEALTH_WARN_HEAP_FREE (1u << HEALTH_TASK_COUNT)
+#define HEALTH_WARN_HEAP_BLOCK (1u << (HEALTH_TASK_COUNT + 1))
+
+typedef struct {
+    const char *name;
+    int32_t stack_free; // Least free stack since the task started (bytes), -1 if not running
+    uint32_t stack_size; // 0 for ESP-IDF tasks
+} health_task_t;
+
+typedef struct {
+    const char *name;
+    uint32_t free;
+    uint32_t min_free;
+    uint32_t largest_block;
+} health_heap_t;
+
+typedef struct {
+    health_task_t tasks[HEALTH_TASK_COUNT]; // Placement plan order, then ESP-IDF tasks
+    health_heap_t heaps[HEALTH_HEAP_COUNT];
+    uint32_t warnings; // HEALTH_WARN_* and task bits
+} health_report_t;
+
+// Start periodic sampling (after the tasks are created, before startup is sealed)
+void health_init(void);
+
+// Take a fresh sample
+void health_sample(health_report_t *out);
+
+#endif // HEALTH_H
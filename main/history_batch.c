@@ -0,0 +1,108 @@
+#include "history_batch.h"
+
+static const char *TAG = "HISTORY";
+
+static batch_sample_t batch[HISTORY_BATCH_SAMPLES];
+static size_t batch_count = 0;
+static int64_t batch_start_us = 0;
+
+static uint8_t scratch[BATCH_RAW_MAX(HISTORY_BATCH_SAMPLES)];
+static uint8_t encoded[PUBLISH_PAYLOAD_MAX * 3 / 4];
+static char payload[PUBLISH_PAYLOAD_MAX + 1];
+
+// Convert a reading to tenths, rounding to nearest
+static int16_t to_tenths(float value) {
+    return (int16_t)(value * 10.0f + (value >= 0 ? 0.5f : -0.5f));
+}
+
+// Encode the first count samples into payload. Returns the text length or 0.
+static size_t encode_prefix(size_t count) {
+    // Timestamps stay monotonic; SNTP only maps the batch base to Unix time
+    uint64_t base_time_ms = time_sync_to_unix_ms(batch_start_us);
+    uint8_t flags = BATCH_FLAG_TIME_SYNCED;
+    if (base_time_ms == 0) {
+        base_time_ms = batch_start_us / 1000;
+        flags = 0;
+    }
+
+    size_t len = batch_encode(batch, count, base_time_ms, flags,
+                              scratch, sizeof(scratch), encoded, sizeof(encoded));
+    return len > 0 ? batch_base64_encode(encoded, len, payload, sizeof(payload)) : 0;
+}
+
+// Remove the first count samples and rebase the rest on the new first one
+static void drop_front(size_t count) {
+    batch_count -= count;
+    if (batch_count == 0) {
+        return;
+    }
+
+    memmove(batch, batch + count, batch_count * sizeof(batch_sample_t));
+    uint32_t base_offset_ms = batch[0].offset_ms;
+    for (size_t i = 0; i < batch_count; i++) {
+        batch[i].offset_ms -= base_offset_ms;
+    }
+    batch_start_us += (int64_t)base_offset_ms * 1000;
+}
+
+// Queue the buffered samples as bulk messages, splitting at the payload limit.
+// Samples that could not be queued stay buffered for the next attempt.
+static void flush_batch(void) {
+    while (batch_count > 0) {
+        size_t count = batch_count;
+        size_t text_len = encode_prefix(count);
+        while (text_len == 0 && count > 1) {
+            text_len = encode_prefix(--count);
+        }
+
+        if (text_len == 0) {
+            ESP_LOGE(TAG, "History sample does not fit in a message, dropping it");
+            drop_front(1);
+            continue;
+        }
+
+        if (!publish_scheduler_submit(FEED_HISTORY, payload, text_len, 1, 0, PUBLISH_PRIO_BULK)) {
+            ESP_LOGW(TAG, "Publish queue full, keeping %u history samples", batch_count);
+            return;
+        }
+
+        ESP_LOGI(TAG, "Queued history batch: %u samples in %u bytes (%u raw)",
+                 count, text_len, count * sizeof(batch_sample_t));
+        drop_front(count);
+    }
+}
+
+// Sample listener (runs in the DHT11 task)
+static void on_sample(const sensor_sample_t *sample) {
+    if (!sample->valid) {
+        return; // Gaps show up in the timestamps
+    }
+
+    if (batch_count == 0) {
+        batch_start_us = sample->timestamp_us;
+    }
+
+    batch[batch_count].offset_ms = (uint32_t)((sample->timestamp_us - batch_start_us) / 1000);
+    batch[batch_count].temperature_x10 = to_tenths(sample->temperature);
+    batch[batch_count].humidity_x10 = to_tenths(sample->humidity);
+    batch_count++;
+
+    if (batch_count == HISTORY_BATCH_SAMPLES) {
+        flush_batch();
+    }
+
+    // Still full after a rejected flush: give up the oldest sample
+    if (batch_count == HISTORY_BATCH_SAMPLES) {
+        drop_front(1);
+    }
+}
+
+void history_batch_init(void) {
+    if (!HISTORY_BATCH_ENABLE) {
+        return;
+    }
+
+    dht11_register_listener(on_sample);
+    ESP_LOGI(TAG, "History batching enabled (%d samples every %d ms)",
+             HISTORY_BATCH_SAMPLES, HISTORY_SAMPLE_DELAY);
+}
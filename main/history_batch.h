@@ -0,0 +1,16 @@
+// history_batch.h
+#ifndef HISTORY_BATCH_H
+#define HISTORY_BATCH_H
+
+#include <stdint.h>
+#include "esp_log.h"
+#include "global_data.h"
+#include "dht11_task.h"
+#include "batch_codec.h"
+#include "time_sync.h"
+#include "publish_scheduler.h"
+
+// Start buffering samples when HISTORY_BATCH_ENABLE is set
+void history_batch_init(void);
+
+#endif // HISTORY_BATCH_H
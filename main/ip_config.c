@@ -0,0 +1,152 @@
+#include "ip_config.h"
+
+static const char *TAG = "IP_CONFIG";
+
+static esp_netif_t *sta_netif = NULL;
+static wifi_static_ip_t static_ip;
+static bool use_static = false;
+
+static bool have_lease = false;
+static uint8_t lease_bssid[6];
+static esp_netif_ip_info_t lease_info;
+
+static int64_t associated_us = 0;
+static ip_config_timing_t timing;
+static portMUX_TYPE timing_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Parse the WIFI_STATIC_* defines; empty WIFI_STATIC_IP keeps DHCP
+static bool load_static_defaults(wifi_static_ip_t *cfg) {
+    memset(cfg, 0, sizeof(*cfg));
+    if (WIFI_STATIC_IP[0] == '\0') {
+        return false;
+    }
+    if (esp_netif_str_to_ip4(WIFI_STATIC_IP, &cfg->info.ip) != ESP_OK ||
+        esp_netif_str_to_ip4(WIFI_STATIC_NETMASK, &cfg->info.netmask) != ESP_OK ||
+        esp_netif_str_to_ip4(WIFI_STATIC_GATEWAY, &cfg->info.gw) != ESP_OK) {
+        ESP_LOGE(TAG, "Invalid WIFI_STATIC_* address, using DHCP");
+        return false;
+    }
+    if (WIFI_STATIC_DNS[0] != '\0') {
+        esp_netif_str_to_ip4(WIFI_STATIC_DNS, &cfg->dns);
+    }
+    return true;
+}
+
+void ip_config_init(esp_netif_t *netif) {
+    sta_netif = netif;
+
+    use_static = (wifi_store_load_static_ip(&static_ip) && static_ip.info.ip.addr != 0) ||
+                 load_static_defaults(&static_ip);
+    if (use_static) {
+        ESP_LOGI(TAG, "Static IP " IPSTR ", gateway " IPSTR,
+                 IP2STR(&static_ip.info.ip), IP2STR(&static_ip.info.gw));
+    }
+}
+
+esp_err_t ip_config_set_static(const wifi_static_ip_t *cfg) {
+    wifi_static_ip_t updated = {0};
+
+    if (cfg != NULL) {
+        updated = *cfg;
+    }
+    esp_err_t err = wifi_store_save_static_ip(&updated);
+    if (err == ESP_OK) {
+        static_ip = updated;
+        use_static = (updated.info.ip.addr != 0) || load_static_defaults(&static_ip);
+    }
+    return err;
+}
+
+void ip_config_set_cached_lease(const uint8_t *bssid, const esp_netif_ip_info_t *lease) {
+    memcpy(lease_bssid, bssid, sizeof(lease_bssid));
+    lease_info = *lease;
+    have_lease = (lease->ip.addr != 0);
+}
+
+// Stop DHCP and assign the address directly; GOT_IP follows immediately
+static void apply_address(const esp_netif_ip_info_t *info, const esp_ip4_addr_t *dns) {
+    esp_err_t err = esp_netif_dhcpc_stop(sta_netif);
+    if (err != ESP_OK && err != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED) {
+        ESP_LOGE(TAG, "Failed to stop DHCP client: %s", esp_err_to_name(err));
+        return;
+    }
+    ESP_ERROR_CHECK(esp_netif_set_ip_info(sta_netif, info));
+
+    if (dns->addr != 0) {
+        esp_netif_dns_info_t dns_info = {0};
+        dns_info.ip.u_addr.ip4.addr = dns->addr;
+        dns_info.ip.type = ESP_IPADDR_TYPE_V4;
+        esp_netif_set_dns_info(sta_netif, ESP_NETIF_DNS_MAIN, &dns_info);
+    }
+}
+
+void ip_config_on_associated(const uint8_t *bssid) {
+    ip_mode_t mode;
+
+    associated_us = esp_timer_get_time();
+    if (sta_netif == NULL) {
+        return;
+    }
+
+    if (use_static) {
+        mode = IP_MODE_STATIC;
+        apply_address(&static_ip.info, &static_ip.dns);
+    } else {
+        // A lease is never applied as a static address: it would outlive its
+        // expiry. DHCP stays on and, with CONFIG_LWIP_DHCP_RESTORE_LAST_IP,
+        // asks for the previous address in one REQUEST/ACK (the server may
+        // refuse it, and the ARP check still runs).
+        mode = IP_MODE_DHCP;
+        if (have_lease && memcmp(bssid, lease_bssid, sizeof(lease_bssid)) == 0) {
+            mode = IP_MODE_CACHED_LEASE;
+            ESP_LOGI(TAG, "Same AP as the last lease, requesting " IPSTR, IP2STR(&lease_info.ip));
+        }
+        esp_err_t err = esp_netif_dhcpc_start(sta_netif);
+        if (err != ESP_OK && err != ESP_ERR_ESP_NETIF_DHCP_ALREADY_STARTED) {
+            ESP_LOGE(TAG, "Failed to start DHCP client: %s", esp_err_to_name(err));
+        }
+    }
+
+    portENTER_CRITICAL(&timing_lock);
+    timing.mode = mode;
+    portEXIT_CRITICAL(&timing_lock);
+}
+
+void ip_config_on_got_ip(void) {
+    if (associated_us == 0) {
+        return;
+    }
+    uint32_t elapsed_ms = (uint32_t)((esp_timer_get_time() - associated_us) / 1000);
+    associated_us = 0;
+
+    portENTER_CRITICAL(&timing_lock);
+    timing.samples++;
+    timing.last_ms = elapsed_ms;
+    if (timing.samples == 1 || elapsed_ms < timing.min_ms) {
+        timing.min_ms = elapsed_ms;
+    }
+    if (elapsed_ms > timing.max_ms) {
+        timing.max_ms = elapsed_ms;
+    }
+    ip_mode_t mode = timing.mode;
+    portEXIT_CRITICAL(&timing_lock);
+
+    ESP_LOGI(TAG, "Association to IP: %u ms (%s)", elapsed_ms, ip_config_mode_name(mode));
+}
+
+void ip_config_get_timing(ip_config_timing_t *out) {
+    portENTER_CRITICAL(&timing_lock);
+    *out = timing;
+    portEXIT_CRITICAL(&timing_lock);
+}
+
+const char *ip_config_mode_name(ip_mode_t mode) {
+    switch (mode) {
+        case IP_MODE_STATIC:
+            return "static";
+        case IP_MODE_CACHED_LEASE:
+            return "dhcp, last lease";
+        default:
+            return "dhcp";
+    }
+}
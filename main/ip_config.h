@@ -0,0 +1,46 @@
+// ip_config.h
+#ifndef IP_CONFIG_H
+#define IP_CONFIG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_timer.h"
+#include "wifi_store.h"
+
+// How the station got its address on the last association
+typedef enum {
+    IP_MODE_DHCP = 0,
+    IP_MODE_STATIC,
+    IP_MODE_CACHED_LEASE // DHCP, rejoining the AP of the stored lease
+} ip_mode_t;
+
+typedef struct {
+    ip_mode_t mode;
+    uint32_t samples;
+    uint32_t last_ms; // Association to IP_EVENT_STA_GOT_IP
+    uint32_t min_ms;
+    uint32_t max_ms;
+} ip_config_timing_t;
+
+// Load static settings (NVS first, then the WIFI_STATIC_* defines)
+void ip_config_init(esp_netif_t *netif);
+
+// Save static settings, used from the next association (NULL or a zero ip
+// clears them: the WIFI_STATIC_* defines apply, else DHCP)
+esp_err_t ip_config_set_static(const wifi_static_ip_t *cfg);
+
+// Last DHCP lease and its AP (reported when the station rejoins that AP)
+void ip_config_set_cached_lease(const uint8_t *bssid, const esp_netif_ip_info_t *lease);
+
+// Event hooks: association (WIFI_EVENT_STA_CONNECTED) and IP_EVENT_STA_GOT_IP
+void ip_config_on_associated(const uint8_t *bssid);
+void ip_config_on_got_ip(void);
+
+void ip_config_get_timing(ip_config_timing_t *timing);
+const char *ip_config_mode_name(ip_mode_t mode);
+
+#endif // IP_CONFIG_H
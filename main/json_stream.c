@@ -0,0 +1,215 @@
+#include "json_stream.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define JSON_MAX_DEPTH 8
+#define JSON_NUMBER_MAX_LEN 31
+
+typedef struct {
+    const char *buf;
+    size_t len;
+    size_t pos;
+} json_cursor_t;
+
+static void skip_whitespace(json_cursor_t *c) {
+    while (c->pos < c->len &&
+           (c->buf[c->pos] == ' ' || c->buf[c->pos] == '\t' ||
+            c->buf[c->pos] == '\n' || c->buf[c->pos] == '\r')) {
+        c->pos++;
+    }
+}
+
+// Consume expected character after optional whitespace
+static bool expect(json_cursor_t *c, char ch) {
+    skip_whitespace(c);
+    if (c->pos < c->len && c->buf[c->pos] == ch) {
+        c->pos++;
+        return true;
+    }
+    return false;
+}
+
+// Scan a string starting at the opening quote; slice excludes quotes
+static bool scan_string(json_cursor_t *c, const char **start, size_t *len) {
+    if (c->pos >= c->len || c->buf[c->pos] != '"') {
+        return false;
+    }
+    size_t begin = ++c->pos;
+
+    while (c->pos < c->len) {
+        char ch = c->buf[c->pos];
+        if (ch == '\\') {
+            c->pos += 2;
+            continue;
+        }
+        if (ch == '"') {
+            *start = &c->buf[begin];
+            *len = c->pos - begin;
+            c->pos++;
+            return true;
+        }
+        c->pos++;
+    }
+    return false;
+}
+
+// Skip a nested object or array, honouring strings
+static bool scan_container(json_cursor_t *c) {
+    char stack[JSON_MAX_DEPTH];
+    int depth = 0;
+
+    while (c->pos < c->len) {
+        char ch = c->buf[c->pos];
+
+        if (ch == '"') {
+            const char *s;
+            size_t n;
+            if (!scan_string(c, &s, &n)) {
+                return false;
+            }
+            continue;
+        }
+        if (ch == '{' || ch == '[') {
+            if (depth == JSON_MAX_DEPTH) {
+                return false;
+            }
+            stack[depth++] = (ch == '{') ? '}' : ']';
+        } else if (ch == '}' || ch == ']') {
+            if (depth == 0 || stack[--depth] != ch) {
+                return false;
+            }
+            if (depth == 0) {
+                c->pos++;
+                return true;
+            }
+        }
+        c->pos++;
+    }
+    return false;
+}
+
+// Match a bare literal (true/false/null)
+static bool scan_literal(json_cursor_t *c, const char *literal) {
+    size_t n = strlen(literal);
+    if (c->len - c->pos >= n && memcmp(&c->buf[c->pos], literal, n) == 0) {
+        c->pos += n;
+        return true;
+    }
+    return false;
+}
+
+static bool scan_number(json_cursor_t *c) {
+    size_t begin = c->pos;
+    while (c->pos < c->len && strchr("+-0123456789.eE", c->buf[c->pos]) != NULL &&
+           c->buf[c->pos] != '\0') {
+        c->pos++;
+    }
+    return c->pos > begin;
+}
+
+// Scan any value and describe it
+static bool scan_value(json_cursor_t *c, json_value_t *value) {
+    skip_whitespace(c);
+    if (c->pos >= c->len) {
+        return false;
+    }
+
+    size_t begin = c->pos;
+    char ch = c->buf[c->pos];
+    bool ok;
+
+    if (ch == '"') {
+        value->type = JSON_STRING;
+        return scan_string(c, &value->start, &value->len);
+    } else if (ch == '{' || ch == '[') {
+        value->type = (ch == '{') ? JSON_OBJECT : JSON_ARRAY;
+        ok = scan_container(c);
+    } else if (ch == 't') {
+        value->type = JSON_TRUE;
+        ok = scan_literal(c, "true");
+    } else if (ch == 'f') {
+        value->type = JSON_FALSE;
+        ok = scan_literal(c, "false");
+    } else if (ch == 'n') {
+        value->type = JSON_NULL;
+        ok = scan_literal(c, "null");
+    } else {
+        value->type = JSON_NUMBER;
+        ok = scan_number(c);
+    }
+
+    value->start = &c->buf[begin];
+    value->len = c->pos - begin;
+    return ok;
+}
+
+int json_stream_parse(const char *json, size_t len, json_field_cb_t cb, void *ctx) {
+    json_cursor_t c = { json, len, 0 };
+    int fields = 0;
+
+    if (!expect(&c, '{')) {
+        return -1;
+    }
+    if (expect(&c, '}')) {
+        return 0;
+    }
+
+    while (1) {
+        const char *key;
+        size_t key_len;
+        json_value_t value;
+
+        skip_whitespace(&c);
+        if (!scan_string(&c, &key, &key_len) || !expect(&c, ':') || !scan_value(&c, &value)) {
+            return -1;
+        }
+
+        fields++;
+        if (!cb(key, key_len, &value, ctx)) {
+            return fields;
+        }
+
+        if (expect(&c, '}')) {
+            return fields;
+        }
+        if (!expect(&c, ',')) {
+            return -1;
+        }
+    }
+}
+
+bool json_key_is(const char *key, size_t key_len, const char *name) {
+    return strlen(name) == key_len && memcmp(key, name, key_len) == 0;
+}
+
+// Copy a number slice into a terminated stack buffer for strtol/strtof
+static bool copy_number(const json_value_t *value, char *buf) {
+    if (value->type != JSON_NUMBER || value->len == 0 || value->len > JSON_NUMBER_MAX_LEN) {
+        return false;
+    }
+    memcpy(buf, value->start, value->len);
+    buf[value->len] = '\0';
+    return true;
+}
+
+bool json_value_to_long(const json_value_t *value, long *out) {
+    char buf[JSON_NUMBER_MAX_LEN + 1];
+    char *end;
+
+    if (!copy_number(value, buf)) {
+        return false;
+    }
+    *out = strtol(buf, &end, 10);
+    return *end == '\0';
+}
+
+bool json_value_to_float(const json_value_t *value, float *out) {
+    char buf[JSON_NUMBER_MAX_LEN + 1];
+    char *end;
+
+    if (!copy_number(value, buf)) {
+        return false;
+    }
+    *out = strtof(buf, &end);
+    return *end == '\0';
+}
@@ -0,0 +1,40 @@
+// json_stream.h
+#ifndef JSON_STREAM_H
+#define JSON_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Single-pass, zero-allocation tokenizer for flat JSON objects. Each member
+// is handed to the callback as slices into the input buffer; nested objects
+// and arrays are passed whole and can be parsed again with json_stream_parse.
+
+typedef enum {
+    JSON_STRING, // Slice excludes quotes, escapes are not decoded
+    JSON_NUMBER,
+    JSON_TRUE,
+    JSON_FALSE,
+    JSON_NULL,
+    JSON_OBJECT, // Slice includes braces
+    JSON_ARRAY   // Slice includes brackets
+} json_type_t;
+
+typedef struct {
+    json_type_t type;
+    const char *start;
+    size_t len;
+} json_value_t;
+
+// Return false to stop parsing
+typedef bool (*json_field_cb_t)(const char *key, size_t key_len,
+                                const json_value_t *value, void *ctx);
+
+// Parse one object. Returns the number of members delivered, or -1 on a
+// syntax error (members before the error have already been delivered).
+int json_stream_parse(const char *json, size_t len, json_field_cb_t cb, void *ctx);
+
+bool json_key_is(const char *key, size_t key_len, const char *name);
+bool json_value_to_long(const json_value_t *value, long *out);
+bool json_value_to_float(const json_value_t *value, float *out);
+
+#endif // JSON_STREAM_H
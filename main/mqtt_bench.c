@@ -0,0 +1,325 @@
+#include "mqtt_bench.h"
+
+#define BENCH_COMMAND_TIMEOUT_MS 2000
+#define BENCH_EARLY_ACKS 8
+
+static const char *TAG = "MQTT_BENCH";
+
+static TaskHandle_t bench_task = NULL;
+static volatile bool broker_connected = false;
+
+// PUBACK capture
+static volatile bool collecting_acks = false;
+static volatile int ack_count = 0;
+static int ack_ids[MQTT_BENCH_PUBLISH_COUNT];
+static int64_t ack_us[MQTT_BENCH_PUBLISH_COUNT];
+
+// Command-to-GPIO capture
+static volatile bool collecting_gpio = false;
+static volatile int64_t gpio_us = 0;
+
+// Alarm event to PUBACK capture. The esp-mqtt task runs above the publisher,
+// so the PUBACK can be handled before the publish call returns its msg_id:
+// PUBACKs seen meanwhile are kept with their time and matched afterwards.
+static volatile bool collecting_alarm = false;
+static volatile int alarm_msg_id = -1;
+static volatile int64_t alarm_ack_us = 0;
+static struct {
+    int msg_id;
+    int64_t us;
+} early_acks[BENCH_EARLY_ACKS];
+static int early_next = 0;
+static portMUX_TYPE alarm_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// WiFi load generator (static: it starts after startup is sealed)
+static volatile bool load_running = false;
+static StackType_t load_stack[MQTT_BENCH_LOAD_STACK];
+static StaticTask_t load_tcb;
+
+static int sent_ids[MQTT_BENCH_PUBLISH_COUNT];
+static int64_t sent_us[MQTT_BENCH_PUBLISH_COUNT];
+static uint32_t samples[MQTT_BENCH_PUBLISH_COUNT];
+
+void mqtt_bench_on_connected(void) {
+    broker_connected = true;
+}
+
+void mqtt_bench_on_puback(int msg_id) {
+    if (collecting_alarm) {
+        int64_t now = esp_timer_get_time();
+        bool matched = false;
+
+        portENTER_CRITICAL(&alarm_lock);
+        if (collecting_alarm && msg_id == alarm_msg_id) {
+            collecting_alarm = false;
+            alarm_ack_us = now;
+            matched = true;
+        } else {
+            early_acks[early_next].msg_id = msg_id;
+            early_acks[early_next].us = now;
+            early_next = (early_next + 1) % BENCH_EARLY_ACKS;
+        }
+        portEXIT_CRITICAL(&alarm_lock);
+
+        if (matched) {
+            xTaskNotifyGive(bench_task);
+            return;
+        }
+    }
+    if (!collecting_acks || ack_count >= MQTT_BENCH_PUBLISH_COUNT) {
+        return;
+    }
+    ack_ids[ack_count] = msg_id;
+    ack_us[ack_count] = esp_timer_get_time();
+    ack_count++;
+    if (ack_count == MQTT_BENCH_PUBLISH_COUNT) {
+        xTaskNotifyGive(bench_task);
+    }
+}
+
+void mqtt_bench_on_gpio_update(void) {
+    if (!collecting_gpio) {
+        return;
+    }
+    collecting_gpio = false;
+    gpio_us = esp_timer_get_time();
+    xTaskNotifyGive(bench_task);
+}
+
+void mqtt_bench_on_alarm_sent(int msg_id) {
+    bool acked = false;
+
+    portENTER_CRITICAL(&alarm_lock);
+    if (collecting_alarm && msg_id > 0) {
+        for (int i = 0; i < BENCH_EARLY_ACKS; i++) {
+            if (early_acks[i].msg_id == msg_id) {
+                collecting_alarm = false;
+                alarm_ack_us = early_acks[i].us;
+                acked = true;
+                break;
+            }
+        }
+        if (!acked) {
+            alarm_msg_id = msg_id;
+        }
+    }
+    portEXIT_CRITICAL(&alarm_lock);
+
+    if (acked) {
+        xTaskNotifyGive(bench_task);
+    }
+}
+
+// qsort comparator for latency samples
+static int compare_samples(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Print a latency distribution as one JSON line
+static void report_distribution(const char *test, int count, int lost, int64_t elapsed_us) {
+    if (count == 0) {
+        printf("BENCH {\"test\":\"%s\",\"n\":0,\"lost\":%d}\n", test, lost);
+        return;
+    }
+
+    qsort(samples, count, sizeof(samples[0]), compare_samples);
+    printf("BENCH {\"test\":\"%s\",\"n\":%d,\"lost\":%d,\"elapsed_us\":%lld,"
+           "\"msg_per_s\":%.1f,\"min_us\":%u,\"p50_us\":%u,\"p90_us\":%u,"
+           "\"p99_us\":%u,\"max_us\":%u}\n",
+           test, count, lost, (long long)elapsed_us,
+           elapsed_us > 0 ? count * 1000000.0 / elapsed_us : 0.0,
+           samples[0], samples[(count - 1) * 50 / 100], samples[(count - 1) * 90 / 100],
+           samples[(count - 1) * 99 / 100], samples[count - 1]);
+}
+
+// Fire-and-forget publish throughput
+static void bench_publish_qos0(esp_mqtt_client_handle_t client) {
+    char payload[16];
+    int failed = 0;
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < MQTT_BENCH_PUBLISH_COUNT; i++) {
+        snprintf(payload, sizeof(payload), "%d", i);
+        if (esp_mqtt_client_publish(client, MQTT_BENCH_TOPIC, payload, 0, 0, 0) < 0) {
+            failed++;
+        }
+    }
+    int64_t elapsed = esp_timer_get_time() - start;
+
+    printf("BENCH {\"test\":\"publish_qos0\",\"n\":%d,\"failed\":%d,"
+           "\"elapsed_us\":%lld,\"msg_per_s\":%.1f}\n",
+           MQTT_BENCH_PUBLISH_COUNT, failed, (long long)elapsed,
+           MQTT_BENCH_PUBLISH_COUNT * 1000000.0 / elapsed);
+}
+
+// QoS 1 throughput and PUBACK round-trip distribution
+static void bench_publish_qos1(esp_mqtt_client_handle_t client) {
+    char payload[16];
+
+    ack_count = 0;
+    collecting_acks = true;
+    ulTaskNotifyTake(pdTRUE, 0);
+
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < MQTT_BENCH_PUBLISH_COUNT; i++) {
+        snprintf(payload, sizeof(payload), "%d", i);
+        sent_us[i] = esp_timer_get_time();
+        sent_ids[i] = esp_mqtt_client_publish(client, MQTT_BENCH_TOPIC, payload, 0, 1, 0);
+    }
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MQTT_BENCH_TIMEOUT_MS));
+    collecting_acks = false;
+
+    // Match acknowledgements to sends by message id
+    int count = 0;
+    int64_t last_ack = start;
+    for (int i = 0; i < MQTT_BENCH_PUBLISH_COUNT; i++) {
+        for (int j = 0; j < ack_count; j++) {
+            if (sent_ids[i] > 0 && ack_ids[j] == sent_ids[i]) {
+                samples[count++] = (uint32_t)(ack_us[j] - sent_us[i]);
+                if (ack_us[j] > last_ack) {
+                    last_ack = ack_us[j];
+                }
+                break;
+            }
+        }
+    }
+
+    report_distribution("publish_qos1_puback", count,
+                        MQTT_BENCH_PUBLISH_COUNT - count, last_ack - start);
+}
+
+// Time from publishing an LED command to the resulting gpio_set_level
+static void bench_led_command(esp_mqtt_client_handle_t client) {
+    int count = 0;
+
+    for (int i = 0; i < MQTT_BENCH_COMMAND_COUNT; i++) {
+        ulTaskNotifyTake(pdTRUE, 0);
+        collecting_gpio = true;
+
+        int64_t start = esp_timer_get_time();
+        esp_mqtt_client_publish(client, CONFIG_FEED_LED1, (i & 1) ? "0" : "1", 0, 1, 0);
+
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BENCH_COMMAND_TIMEOUT_MS)) > 0) {
+            samples[count++] = (uint32_t)(gpio_us - start);
+        }
+        collecting_gpio = false;
+    }
+
+    report_distribution("led_command_to_gpio", count, MQTT_BENCH_COMMAND_COUNT - count, 0);
+}
+
+// Alarm event queued behind pending telemetry until its PUBACK arrives
+static void bench_alarm_event(void) {
+    char payload[64];
+    int count = 0;
+
+    for (int i = 0; i < MQTT_BENCH_ALARM_COUNT; i++) {
+        // Filler telemetry stays on the bench topic, away from the real feeds
+        snprintf(payload, sizeof(payload), "%d", i);
+        publish_scheduler_submit(MQTT_BENCH_TOPIC, payload, 0, 1, 0, PUBLISH_PRIO_TELEMETRY);
+
+        ulTaskNotifyTake(pdTRUE, 0);
+        portENTER_CRITICAL(&alarm_lock);
+        alarm_msg_id = -1;
+        memset(early_acks, 0, sizeof(early_acks));
+        collecting_alarm = true;
+        portEXIT_CRITICAL(&alarm_lock);
+
+        // Submitted directly so the alarm_events dedup state is left untouched
+        int64_t start = esp_timer_get_time();
+        snprintf(payload, sizeof(payload), "{\"seq\":%d,\"ts_us\":%lld}", i, (long long)start);
+        publish_scheduler_submit(MQTT_BENCH_ALARM_TOPIC, payload, 0, 1, 0, PUBLISH_PRIO_ALARM);
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(BENCH_COMMAND_TIMEOUT_MS)) > 0) {
+            samples[count++] = (uint32_t)(alarm_ack_us - start);
+        }
+        collecting_alarm = false;
+
+        vTaskDelay(pdMS_TO_TICKS(MQTT_BENCH_ALARM_INTERVAL_MS));
+    }
+
+    report_distribution("alarm_to_puback", count, MQTT_BENCH_ALARM_COUNT - count, 0);
+}
+
+// Saturate the uplink with QoS 0 publishes until load_running drops
+static void load_task(void *param) {
+    static char payload[MQTT_BENCH_LOAD_PAYLOAD];
+
+    memset(payload, 'x', sizeof(payload));
+    while (load_running) {
+        esp_mqtt_client_publish((esp_mqtt_client_handle_t)param, MQTT_BENCH_TOPIC,
+                                payload, sizeof(payload), 0, 0);
+        vTaskDelay(1);
+    }
+    vTaskDelete(NULL);
+}
+
+// Sensor read failures and periodic publish jitter under WiFi load. Run
+// with APP_TASK_PINNING on and off to compare the two task placements.
+static void bench_sensor_under_load(esp_mqtt_client_handle_t client) {
+    const task_plan_entry_t *mqtt = task_plan_get(TASK_PLAN_MQTT);
+    dht11_stats_t before, after;
+    int count = 0;
+
+    dht11_get_stats(&before);
+    load_running = true;
+    if (xTaskCreateStaticPinnedToCore(load_task, "bench_load", sizeof(load_stack), client,
+                                      mqtt->priority, load_stack, &load_tcb, mqtt->core) == NULL) {
+        ESP_LOGE(TAG, "Failed to start the load task");
+        load_running = false;
+        return;
+    }
+
+    // Deviation of each publish from the period since the previous one
+    TickType_t wake = xTaskGetTickCount();
+    int64_t start = esp_timer_get_time();
+    int64_t last = 0;
+    for (int i = 0; i <= MQTT_BENCH_JITTER_COUNT; i++) {
+        vTaskDelayUntil(&wake, pdMS_TO_TICKS(MQTT_BENCH_JITTER_PERIOD_MS));
+        esp_mqtt_client_publish(client, MQTT_BENCH_TOPIC, "tick", 0, 0, 0);
+
+        int64_t now = esp_timer_get_time();
+        if (i > 0) {
+            int64_t deviation = now - last - MQTT_BENCH_JITTER_PERIOD_MS * 1000;
+            samples[count++] = (uint32_t)(deviation < 0 ? -deviation : deviation);
+        }
+        last = now;
+    }
+    load_running = false;
+    dht11_get_stats(&after);
+    vTaskDelay(pdMS_TO_TICKS(100)); // Let the load task exit
+
+    report_distribution("publish_jitter_under_load", count, 0, esp_timer_get_time() - start);
+
+    uint32_t reads = after.reads - before.reads;
+    uint32_t failures = after.failures - before.failures;
+    printf("BENCH {\"test\":\"dht11_under_load\",\"pinned\":%d,\"n\":%u,\"failed\":%u,"
+           "\"timeouts\":%u,\"failure_pct\":%.1f}\n",
+           mqtt->core != tskNO_AFFINITY, reads, failures, after.timeouts - before.timeouts,
+           reads ? failures * 100.0 / reads : 0.0);
+}
+
+void mqtt_bench_run(esp_mqtt_client_handle_t client) {
+    bench_task = xTaskGetCurrentTaskHandle();
+
+    int waited_ms = 0;
+    while (!broker_connected && waited_ms < MQTT_BENCH_TIMEOUT_MS) {
+        vTaskDelay(pdMS_TO_TICKS(100));
+        waited_ms += 100;
+    }
+    if (!broker_connected) {
+        ESP_LOGE(TAG, "Broker not connected, benchmark skipped");
+        return;
+    }
+    vTaskDelay(pdMS_TO_TICKS(1000)); // Let the LED subscriptions settle
+
+    ESP_LOGI(TAG, "Running MQTT benchmark against %s", CONFIG_BROKER_URI);
+    bench_publish_qos0(client);
+    bench_publish_qos1(client);
+    bench_led_command(client);
+    bench_alarm_event();
+    bench_sensor_under_load(client);
+    ESP_LOGI(TAG, "MQTT benchmark finished");
+}
@@ -0,0 +1,42 @@
+// mqtt_bench.h
+#ifndef MQTT_BENCH_H
+#define MQTT_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mqtt_client.h"
+#include "publish_scheduler.h"
+#include "dht11_task.h"
+#include "task_plan.h"
+
+// Benchmark mode: point CONFIG_BROKER_URI at a local mosquitto and set to 1
+#define MQTT_BENCH_ENABLE 0
+
+#define MQTT_BENCH_TOPIC CONFIG_USERNAME "/feeds/bench"
+#define MQTT_BENCH_ALARM_TOPIC CONFIG_USERNAME "/feeds/bench-alarm"
+#define MQTT_BENCH_PUBLISH_COUNT 200
+#define MQTT_BENCH_COMMAND_COUNT 50
+#define MQTT_BENCH_TIMEOUT_MS 10000
+#define MQTT_BENCH_ALARM_COUNT 20
+#define MQTT_BENCH_ALARM_INTERVAL_MS 2500 // Lets the publish token bucket refill
+#define MQTT_BENCH_JITTER_COUNT 200 // Periodic publishes while the uplink is loaded
+#define MQTT_BENCH_JITTER_PERIOD_MS 250
+#define MQTT_BENCH_LOAD_PAYLOAD 512 // QoS 0 flood from a second task on the MQTT core
+#define MQTT_BENCH_LOAD_STACK 3072
+
+// Run all benchmarks and print one "BENCH {json}" line per result
+void mqtt_bench_run(esp_mqtt_client_handle_t client);
+
+// Hooks called from the MQTT path
+void mqtt_bench_on_connected(void);
+void mqtt_bench_on_puback(int msg_id);
+void mqtt_bench_on_gpio_update(void);
+void mqtt_bench_on_alarm_sent(int msg_id);
+
+#endif // MQTT_BENCH_H
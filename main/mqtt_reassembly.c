@@ -0,0 +1,106 @@
+#include "mqtt_reassembly.h"
+#include <string.h>
+
+typedef struct {
+    mqtt_message_t msg;
+    bool in_use;
+    bool complete;
+    int msg_id;
+    size_t total_len;
+    uint32_t seq;
+} reassembly_slot_t;
+
+static reassembly_slot_t slots[REASSEMBLY_SLOT_COUNT];
+static uint32_t next_seq = 0;
+static uint32_t dropped = 0;
+
+// Claim a slot for a new message, evicting the oldest incomplete one if needed
+static reassembly_slot_t *claim_slot(void) {
+    reassembly_slot_t *oldest = NULL;
+
+    for (int i = 0; i < REASSEMBLY_SLOT_COUNT; i++) {
+        if (!slots[i].in_use) {
+            return &slots[i];
+        }
+        if (!slots[i].complete && (oldest == NULL || slots[i].seq < oldest->seq)) {
+            oldest = &slots[i];
+        }
+    }
+
+    if (oldest != NULL) {
+        dropped++;
+    }
+    return oldest;
+}
+
+// Find the in-progress slot this continuation fragment belongs to
+static reassembly_slot_t *find_slot(int msg_id, size_t offset, size_t total_len) {
+    for (int i = 0; i < REASSEMBLY_SLOT_COUNT; i++) {
+        reassembly_slot_t *slot = &slots[i];
+        if (slot->in_use && !slot->complete && slot->msg_id == msg_id &&
+            slot->total_len == total_len && slot->msg.data_len == offset) {
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+const mqtt_message_t *mqtt_reassembly_feed(int msg_id, const char *topic, size_t topic_len,
+                                           const char *data, size_t data_len,
+                                           size_t offset, size_t total_len) {
+    reassembly_slot_t *slot;
+
+    if (offset == 0) {
+        if (topic_len >= REASSEMBLY_MAX_TOPIC || total_len > REASSEMBLY_MAX_DATA) {
+            dropped++;
+            return NULL;
+        }
+        slot = claim_slot();
+        if (slot == NULL) {
+            dropped++;
+            return NULL;
+        }
+        slot->in_use = true;
+        slot->complete = false;
+        slot->msg_id = msg_id;
+        slot->total_len = total_len;
+        slot->seq = next_seq++;
+        memcpy(slot->msg.topic, topic, topic_len);
+        slot->msg.topic[topic_len] = '\0';
+        slot->msg.topic_len = topic_len;
+        slot->msg.data_len = 0;
+    } else {
+        slot = find_slot(msg_id, offset, total_len);
+        if (slot == NULL) {
+            return NULL; // Head fragment was dropped or a chunk went missing
+        }
+    }
+
+    if (slot->msg.data_len + data_len > slot->total_len) {
+        slot->in_use = false;
+        dropped++;
+        return NULL;
+    }
+
+    memcpy(&slot->msg.data[slot->msg.data_len], data, data_len);
+    slot->msg.data_len += data_len;
+
+    if (slot->msg.data_len < slot->total_len) {
+        return NULL;
+    }
+    slot->complete = true;
+    return &slot->msg;
+}
+
+void mqtt_reassembly_release(const mqtt_message_t *msg) {
+    for (int i = 0; i < REASSEMBLY_SLOT_COUNT; i++) {
+        if (&slots[i].msg == msg) {
+            slots[i].in_use = false;
+            slots[i].complete = false;
+        }
+    }
+}
+
+uint32_t mqtt_reassembly_dropped(void) {
+    return dropped;
+}
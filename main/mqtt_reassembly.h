@@ -0,0 +1,33 @@
+// mqtt_reassembly.h
+#ifndef MQTT_REASSEMBLY_H
+#define MQTT_REASSEMBLY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Buffer pool for MQTT messages delivered in several MQTT_EVENT_DATA chunks
+#define REASSEMBLY_SLOT_COUNT 2
+#define REASSEMBLY_MAX_TOPIC 128
+#define REASSEMBLY_MAX_DATA 2048
+
+typedef struct {
+    char topic[REASSEMBLY_MAX_TOPIC];
+    size_t topic_len;
+    char data[REASSEMBLY_MAX_DATA];
+    size_t data_len;
+} mqtt_message_t;
+
+// Feed one fragment. topic is only present on the first fragment (offset 0).
+// Returns the completed message (release it after use) or NULL while more
+// fragments are expected or the fragment was rejected.
+const mqtt_message_t *mqtt_reassembly_feed(int msg_id, const char *topic, size_t topic_len,
+                                           const char *data, size_t data_len,
+                                           size_t offset, size_t total_len);
+
+void mqtt_reassembly_release(const mqtt_message_t *msg);
+
+// Messages dropped because they were too large or fragments went missing
+uint32_t mqtt_reassembly_dropped(void);
+
+#endif // MQTT_REASSEMBLY_H
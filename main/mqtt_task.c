@@ -2,58 +2,230 @@
 
 static const char *TAG = "MQTT_TASK";
 static esp_mqtt_client_handle_t client = NULL;
+static char client_id[32];
 
-// Update LED states based on global variables
-static void update_led_states(void) {
-    gpio_set_level(LED1_GPIO, led1_state ? 1 : 0);
-    gpio_set_level(LED2_GPIO, led2_state ? 1 : 0);
-    ESP_LOGI(TAG, "LED states updated: LED1=%d, LED2=%d", led1_state, led2_state);
-}
-
-// Initialize LED GPIOs
-static void init_led_gpios(void) {
-    gpio_set_direction(LED1_GPIO, GPIO_MODE_OUTPUT);
-    gpio_set_direction(LED2_GPIO, GPIO_MODE_OUTPUT);
-    update_led_states();
-}
+// Fast resume bookkeeping
+static int64_t connected_us = 0;
+static uint32_t resumed_mask = 0;
 
 // Publish sensor data to MQTT
 static void mqtt_publish_sensor_data(float temp, float hum) {
     char payload[16];
     
-    // Publish temperature
+    // Queue temperature
     snprintf(payload, sizeof(payload), "%.1f", temp);
-    esp_mqtt_client_publish(client, CONFIG_FEED_TEMP, payload, 0, 1, 0);
+    publish_scheduler_submit(CONFIG_FEED_TEMP, payload, 0, 1, 0, PUBLISH_PRIO_TELEMETRY);
     
-    // Publish humidity
+    // Queue humidity
     snprintf(payload, sizeof(payload), "%.1f", hum);
-    esp_mqtt_client_publish(client, CONFIG_FEED_HUMID, payload, 0, 1, 0);
+    publish_scheduler_submit(CONFIG_FEED_HUMID, payload, 0, 1, 0, PUBLISH_PRIO_TELEMETRY);
     
-    ESP_LOGI(TAG, "Published sensor data: Temp=%.1f°C, Humidity=%.1f%%", temp, hum);
+    ESP_LOGI(TAG, "Queued sensor data: Temp=%.1f°C, Humidity=%.1f%%", temp, hum);
 }
 
-// Process LED control command
-static void process_led_command(const char* topic, const char* data, 
-                               size_t topic_len, size_t data_len) {
-    bool new_state = (strncmp(data, "1", data_len) == 0);
-    
-    if (strncmp(topic, CONFIG_FEED_LED1, topic_len) == 0) {
-        led1_state = new_state;
-        ESP_LOGI(TAG, "LED1 set to: %d", led1_state);
-    } 
-    else if (strncmp(topic, CONFIG_FEED_LED2, topic_len) == 0) {
-        led2_state = new_state;
-        ESP_LOGI(TAG, "LED2 set to: %d", led2_state);
+// Topics that make the broker resend the last value of each actuator feed
+static char get_topics[ACTUATOR_MAX][96];
+
+// Fields collected from one JSON command
+typedef struct {
+    bool has_leds;
+    uint32_t leds;
+    uint32_t mask;
+    bool has_alarm;
+    alarm_config_t alarm; // Current config with the received fields applied
+    bool has_interval;
+    uint32_t interval_ms;
+} json_command_t;
+
+typedef bool (*command_field_handler_t)(const json_value_t *value, json_command_t *cmd);
+
+// Log boot-to-correct-state time once every actuator has received its state
+static void track_state_resume(size_t index) {
+    if (resumed_mask == actuator_all_mask()) {
+        return;
     }
-    
-    update_led_states();
+
+    resumed_mask |= 1u << index;
+    if (resumed_mask == actuator_all_mask()) {
+        int64_t now = esp_timer_get_time();
+        ESP_LOGI(TAG, "Actuator state resumed %lld ms after boot (%lld ms after connect)",
+                 (long long)(now / 1000), (long long)((now - connected_us) / 1000));
+    }
+}
+
+// Ask the broker to resend the current value of every actuator feed
+static void request_actuator_state(void) {
+    for (size_t i = 0; i < actuator_count(); i++) {
+        publish_scheduler_submit(get_topics[i], "", 0, 0, 0, PUBLISH_PRIO_STATE);
+    }
+}
+
+// Process an on/off command for the routed actuator
+static void process_actuator_command(const char *topic, size_t topic_len,
+                                     const char *data, size_t data_len, void *ctx) {
+    size_t index = (size_t)(uintptr_t)ctx;
+    bool on = (data_len == 1 && data[0] == '1');
+
+    ESP_LOGD(TAG, "%s command: %d", actuator_get(index)->name, on);
+    actuator_set(index, on);
+    track_state_resume(index);
+}
+
+// "leds": actuator on/off bits (bit 0 = LED1)
+static bool command_field_leds(const json_value_t *value, json_command_t *cmd) {
+    long leds;
+    if (!json_value_to_long(value, &leds) || leds < 0 || (leds & ~(long)actuator_all_mask())) {
+        return false;
+    }
+    cmd->leds = (uint32_t)leds;
+    cmd->has_leds = true;
+    return true;
+}
+
+// "mask": which actuators "leds" applies to (default: all)
+static bool command_field_mask(const json_value_t *value, json_command_t *cmd) {
+    long mask;
+    if (!json_value_to_long(value, &mask) || mask < 0 || (mask & ~(long)actuator_all_mask())) {
+        return false;
+    }
+    cmd->mask = (uint32_t)mask;
+    return true;
+}
+
+// "threshold"/"critical": critical alarm temperature in °C
+static bool command_field_critical(const json_value_t *value, json_command_t *cmd) {
+    if (!json_value_to_float(value, &cmd->alarm.critical_c)) {
+        return false;
+    }
+    cmd->has_alarm = true;
+    return true;
+}
+
+// "warning": warning alarm temperature in °C
+static bool command_field_warning(const json_value_t *value, json_command_t *cmd) {
+    if (!json_value_to_float(value, &cmd->alarm.warning_c)) {
+        return false;
+    }
+    cmd->has_alarm = true;
+    return true;
+}
+
+// "hysteresis": °C below a level before it clears
+static bool command_field_hysteresis(const json_value_t *value, json_command_t *cmd) {
+    if (!json_value_to_float(value, &cmd->alarm.hysteresis_c)) {
+        return false;
+    }
+    cmd->has_alarm = true;
+    return true;
+}
+
+// "horizon": pre-alarm horizon in seconds (0 = off)
+static bool command_field_horizon(const json_value_t *value, json_command_t *cmd) {
+    long seconds;
+    if (!json_value_to_long(value, &seconds) || seconds < 0) {
+        return false;
+    }
+    cmd->alarm.prealarm_horizon_s = (uint32_t)seconds;
+    cmd->has_alarm = true;
+    return true;
+}
+
+// "interval": telemetry publish interval in seconds
+static bool command_field_interval(const json_value_t *value, json_command_t *cmd) {
+    long seconds;
+    if (!json_value_to_long(value, &seconds) || seconds <= 0 ||
+        seconds * 1000 < MQTT_PUBLISH_DELAY_MIN || seconds * 1000 > MQTT_PUBLISH_DELAY_MAX) {
+        return false;
+    }
+    cmd->interval_ms = (uint32_t)seconds * 1000;
+    cmd->has_interval = true;
+    return true;
+}
+
+static const struct {
+    const char *name;
+    command_field_handler_t handler;
+} command_fields[] = {
+    { "leds", command_field_leds },
+    { "mask", command_field_mask },
+    { "threshold", command_field_critical },
+    { "critical", command_field_critical },
+    { "warning", command_field_warning },
+    { "hysteresis", command_field_hysteresis },
+    { "horizon", command_field_horizon },
+    { "interval", command_field_interval },
+};
+
+// Tokenizer callback: hand each field straight to its handler
+static bool dispatch_command_field(const char *key, size_t key_len,
+                                   const json_value_t *value, void *ctx) {
+    for (size_t i = 0; i < sizeof(command_fields) / sizeof(command_fields[0]); i++) {
+        if (json_key_is(key, key_len, command_fields[i].name)) {
+            if (!command_fields[i].handler(value, (json_command_t *)ctx)) {
+                ESP_LOGW(TAG, "Invalid value for command field: %.*s", (int)key_len, key);
+            }
+            return true;
+        }
+    }
+    ESP_LOGW(TAG, "Unknown command field: %.*s", (int)key_len, key);
+    return true;
 }
 
-// Subscribe to LED control topics
+// Process JSON command, e.g. {"leds":3,"mask":1,"warning":35,"critical":40,"interval":30}
+static void process_json_command(const char *topic, size_t topic_len,
+                                 const char *data, size_t data_len, void *ctx) {
+    json_command_t cmd = { .mask = UINT32_MAX };
+    alarm_monitor_get_config(&cmd.alarm);
+
+    if (json_stream_parse(data, data_len, dispatch_command_field, &cmd) < 0) {
+        ESP_LOGW(TAG, "Malformed JSON command");
+        return;
+    }
+
+    if (cmd.has_leds) {
+        actuator_set_mask(cmd.leds, cmd.mask);
+    }
+
+    if (cmd.has_alarm && alarm_monitor_set_config(&cmd.alarm) == ESP_ERR_INVALID_ARG) {
+        ESP_LOGW(TAG, "Rejected alarm thresholds (out of range, or warning above critical)");
+    }
+
+    if (cmd.has_interval) {
+        mqtt_publish_interval_ms = cmd.interval_ms;
+        ESP_LOGI(TAG, "Publish interval set to: %u ms", mqtt_publish_interval_ms);
+    }
+}
+
+// Register handlers for all command topics
+static void register_topic_routes(void) {
+    for (size_t i = 0; i < actuator_count(); i++) {
+        const actuator_def_t *def = actuator_get(i);
+        snprintf(get_topics[i], sizeof(get_topics[i]), "%s" MQTT_GET_SUFFIX, def->topic);
+        topic_router_register(def->topic, process_actuator_command, (void *)(uintptr_t)i);
+    }
+    topic_router_register(FEED_COMMAND, process_json_command, NULL);
+}
+
+// Subscribe to a single routed topic filter
+static void subscribe_route(const char *filter, void *arg) {
+    esp_mqtt_client_subscribe(client, filter, 1);
+    ESP_LOGI(TAG, "Subscribed to: %s", filter);
+}
+
+// Subscribe to all routed command topics
 static void subscribe_to_topics(void) {
-    esp_mqtt_client_subscribe(client, CONFIG_FEED_LED1, 1);
-    esp_mqtt_client_subscribe(client, CONFIG_FEED_LED2, 1);
-    ESP_LOGI(TAG, "Subscribed to LED control topics");
+    topic_router_for_each(subscribe_route, NULL);
+}
+
+// Dispatch a complete message to its route
+static void handle_message(const char *topic, size_t topic_len,
+                           const char *data, size_t data_len) {
+    ESP_LOGI(TAG, "Received MQTT data on topic: %.*s | data: %.*s",
+             (int)topic_len, topic, (int)data_len, data);
+
+    if (!topic_router_dispatch(topic, topic_len, data, data_len)) {
+        ESP_LOGW(TAG, "No handler for topic: %.*s", (int)topic_len, topic);
+    }
 }
 
 // MQTT event handler
@@ -61,23 +233,51 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
                               int32_t event_id, void *event_data) {
     esp_mqtt_event_handle_t event = event_data;
 
+    broker_manager_on_event(event);
+    mqtt_tls_on_event(event);
+
     switch ((esp_mqtt_event_id_t)event_id) {
         case MQTT_EVENT_CONNECTED:
-            ESP_LOGI(TAG, "MQTT connected successfully");
-            subscribe_to_topics();
+            ESP_LOGI(TAG, "MQTT connected successfully (session present: %d)",
+                     event->session_present);
+            connected_us = esp_timer_get_time();
+            net_state_set(NET_BROKER_UP);
+
+            // A resumed persistent session still holds our subscriptions
+            if (!(MQTT_FAST_RESUME && event->session_present)) {
+                subscribe_to_topics();
+            }
+            publish_scheduler_set_client(event->client);
+            publish_scheduler_submit(FEED_STATUS, "online", 0, 1, 1, PUBLISH_PRIO_STATE);
+            if (MQTT_FAST_RESUME) {
+                request_actuator_state();
+            }
+            mqtt_bench_on_connected();
+            break;
+
+        case MQTT_EVENT_PUBLISHED:
+            mqtt_bench_on_puback(event->msg_id);
             break;
 
         case MQTT_EVENT_DATA:
-            ESP_LOGI(TAG, "Received MQTT data on topic: %.*s | data: %.*s",
-                     event->topic_len, event->topic,
-                     event->data_len, event->data);
-            
-            process_led_command(event->topic, event->data, 
-                              event->topic_len, event->data_len);
+            if (event->current_data_offset == 0 && event->data_len == event->total_data_len) {
+                handle_message(event->topic, event->topic_len, event->data, event->data_len);
+            } else {
+                // Large payloads arrive in several events; topic is on the first only
+                const mqtt_message_t *msg = mqtt_reassembly_feed(
+                    event->msg_id, event->topic, event->topic_len, event->data,
+                    event->data_len, event->current_data_offset, event->total_data_len);
+                if (msg != NULL) {
+                    handle_message(msg->topic, msg->topic_len, msg->data, msg->data_len);
+                    mqtt_reassembly_release(msg);
+                }
+            }
             break;
 
         case MQTT_EVENT_DISCONNECTED:
             ESP_LOGW(TAG, "MQTT disconnected");
+            net_state_clear(NET_BROKER_UP);
+            publish_scheduler_set_client(NULL);
             break;
 
         case MQTT_EVENT_ERROR:
@@ -90,13 +290,54 @@ static void mqtt_event_handler(void *handler_args, esp_event_base_t base,
     }
 }
 
+// Build a client id that stays the same across reboots (needed for persistent sessions)
+static void init_client_id(void) {
+    uint8_t mac[6];
+    esp_read_mac(mac, ESP_MAC_WIFI_STA);
+    snprintf(client_id, sizeof(client_id), "tepbac-%02x%02x%02x%02x%02x%02x",
+             mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+// Fill the client configuration for the currently selected broker
+static void build_client_config(esp_mqtt_client_config_t *mqtt_cfg) {
+    const broker_config_t *broker = broker_manager_selected();
+
+    *mqtt_cfg = (esp_mqtt_client_config_t) {
+        .uri = broker->uri,
+        .username = broker->username,
+        .password = broker->password,
+        .client_id = client_id,
+        .reconnect_timeout_ms = BROKER_RECONNECT_TIMEOUT_MS,
+        .disable_clean_session = MQTT_FAST_RESUME,
+        .lwt_topic = FEED_STATUS,
+        .lwt_msg = "offline",
+        .lwt_qos = 1,
+        .lwt_retain = 1
+    };
+    mqtt_tls_apply(mqtt_cfg);
+}
+
+// Point the running client at the newly selected broker. The same client is
+// reused so its outbox (unacknowledged QoS 1 messages) survives the switch.
+static void switch_broker(void) {
+    esp_mqtt_client_config_t mqtt_cfg;
+    build_client_config(&mqtt_cfg);
+
+    publish_scheduler_set_client(NULL);
+    broker_manager_expect_disconnect();
+    esp_mqtt_client_disconnect(client);
+    esp_mqtt_set_config(client, &mqtt_cfg); // Copies the strings (library heap, once per switch)
+    esp_mqtt_client_reconnect(client);
+}
+
 // Initialize MQTT client
 static esp_mqtt_client_handle_t init_mqtt_client(void) {
-    esp_mqtt_client_config_t mqtt_cfg = {
-        .uri = CONFIG_BROKER_URI,
-        .username = CONFIG_USERNAME,
-        .password = CONFIG_AIO_KEY
-    };
+    init_client_id();
+    mqtt_tls_init();
+    broker_manager_init();
+
+    esp_mqtt_client_config_t mqtt_cfg;
+    build_client_config(&mqtt_cfg);
 
     esp_mqtt_client_handle_t mqtt_client = esp_mqtt_client_init(&mqtt_cfg);
     if (mqtt_client == NULL) {
@@ -109,19 +350,18 @@ static esp_mqtt_client_handle_t init_mqtt_client(void) {
     return mqtt_client;
 }
 
-// Wait for WiFi connection
+// Block until the station has an IP address
 static void wait_for_wifi_connection(void) {
-    while (!wifi_connected) {
+    if (!net_state_is(NET_GOT_IP)) {
         ESP_LOGI(TAG, "Waiting for WiFi connection...");
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        net_state_wait(NET_GOT_IP, NET_WAIT_FOREVER);
     }
     ESP_LOGI(TAG, "WiFi connection established");
 }
 
 // Main MQTT task
 void mqtt_task_pubsub(void *param) {
-    // Initialize hardware
-    init_led_gpios();
+    register_topic_routes();
     
     // Wait for WiFi connection
     wait_for_wifi_connection();
@@ -130,22 +370,48 @@ void mqtt_task_pubsub(void *param) {
     client = init_mqtt_client();
     if (client == NULL) {
         ESP_LOGE(TAG, "Failed to create MQTT client, terminating task");
-        vTaskDelete(NULL);
+        task_plan_exit(TASK_PLAN_MQTT);
         return;
     }
 
     esp_mqtt_client_start(client);
     ESP_LOGI(TAG, "MQTT client started");
 
-    // Main publishing loop
-    while (wifi_connected) {
-        mqtt_publish_sensor_data(temperature, humidity);
-        vTaskDelay(pdMS_TO_TICKS(MQTT_PUBLISH_DELAY));
-    }
+    // Last startup step: tasks, console, WiFi and the client now exist
+    static_mem_seal();
 
-    // Cleanup when WiFi disconnects
-    ESP_LOGW(TAG, "WiFi disconnected. Stopping MQTT client and task.");
-    esp_mqtt_client_stop(client);
-    esp_mqtt_client_destroy(client);
-    vTaskDelete(NULL);
+#if MQTT_BENCH_ENABLE
+    mqtt_bench_run(client);
+#endif
+
+    // Main loop: telemetry on its interval, broker health every second.
+    // Losing the IP wakes the loop at once instead of on the next pass.
+    int64_t next_publish_us = 0;
+    while (1) {
+        net_state_clear(NET_IP_LOST);
+        if (!net_state_is(NET_GOT_IP)) {
+            // Pause the client while WiFi is down; it resumes on the next IP.
+            // Disconnect/reconnect keeps the esp-mqtt task and its buffers
+            // (stop/start would free and recreate them after the seal).
+            ESP_LOGW(TAG, "WiFi disconnected. Pausing MQTT client.");
+            publish_scheduler_set_client(NULL);
+            net_state_clear(NET_BROKER_UP);
+            broker_manager_expect_disconnect();
+            esp_mqtt_client_disconnect(client);
+
+            wait_for_wifi_connection();
+            esp_mqtt_client_reconnect(client);
+        }
+
+        int64_t now = esp_timer_get_time();
+        if (now >= next_publish_us) {
+            mqtt_publish_sensor_data(temperature, humidity);
+            next_publish_us = now + (int64_t)mqtt_publish_interval_ms * 1000;
+        }
+
+        if (broker_manager_evaluate()) {
+            switch_broker();
+        }
+        net_state_wait(NET_IP_LOST, BROKER_EVAL_INTERVAL_MS);
+    }
 }
\ No newline at end of file
@@ -10,7 +10,20 @@
 #include "esp_log.h"
 #include "mqtt_client.h"
 #include "global_data.h"
-#include "driver/gpio.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "topic_router.h"
+#include "publish_scheduler.h"
+#include "mqtt_bench.h"
+#include "mqtt_reassembly.h"
+#include "json_stream.h"
+#include "broker_manager.h"
+#include "mqtt_tls.h"
+#include "net_state.h"
+#include "static_mem.h"
+#include "alarm_monitor.h"
+#include "actuator.h"
+#include "task_plan.h"
 
 void mqtt_task_pubsub(void *param);
 
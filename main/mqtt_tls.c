@@ -0,0 +1,96 @@
+#include "mqtt_tls.h"
+
+static const char *TAG = "MQTT_TLS";
+
+static mqtt_tls_stats_t stats = { .min_ms = UINT32_MAX };
+static esp_timer_handle_t heap_sampler = NULL;
+static int64_t connect_started_us = 0;
+static volatile size_t heap_at_start = 0;
+static volatile size_t heap_low = 0;
+static bool connecting = false;
+static bool timed = false; // Current URI is mqtts://
+
+// Track the lowest free internal heap seen during the connect
+static void sample_heap(void *arg) {
+    size_t free_now = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    if (free_now < heap_low) {
+        heap_low = free_now;
+    }
+}
+
+void mqtt_tls_init(void) {
+    const esp_timer_create_args_t args = {
+        .callback = sample_heap,
+        .name = "tls_heap"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&args, &heap_sampler));
+}
+
+static void start_measurement(void) {
+    heap_at_start = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+    heap_low = heap_at_start;
+    connect_started_us = esp_timer_get_time();
+    connecting = true;
+    esp_timer_start_periodic(heap_sampler, MQTT_TLS_HEAP_SAMPLE_US);
+}
+
+static void finish_measurement(bool success) {
+    if (!connecting) {
+        return;
+    }
+    connecting = false;
+    esp_timer_stop(heap_sampler);
+    sample_heap(NULL);
+
+    uint32_t elapsed_ms = (uint32_t)((esp_timer_get_time() - connect_started_us) / 1000);
+    uint32_t heap_peak = heap_at_start - heap_low;
+
+    if (!success) {
+        stats.failures++;
+        ESP_LOGW(TAG, "Connect failed after %u ms (heap peak %u bytes)", elapsed_ms, heap_peak);
+        return;
+    }
+
+    stats.connects++;
+    stats.last_ms = elapsed_ms;
+    stats.last_heap_peak = heap_peak;
+    if (elapsed_ms < stats.min_ms) stats.min_ms = elapsed_ms;
+    if (elapsed_ms > stats.max_ms) stats.max_ms = elapsed_ms;
+    if (heap_peak > stats.max_heap_peak) stats.max_heap_peak = heap_peak;
+
+    ESP_LOGI(TAG, "Connect #%u took %u ms, heap peak %u bytes (min %u / max %u ms)",
+             stats.connects, elapsed_ms, heap_peak, stats.min_ms, stats.max_ms);
+}
+
+void mqtt_tls_apply(esp_mqtt_client_config_t *cfg) {
+    timed = strncmp(cfg->uri, "mqtts://", 8) == 0;
+    if (strncmp(cfg->uri, "mqtts://", 8) == 0 || strncmp(cfg->uri, "wss://", 6) == 0) {
+        // The bundle lives in flash; only the matching CA is parsed at handshake
+        cfg->crt_bundle_attach = esp_crt_bundle_attach;
+    }
+}
+
+void mqtt_tls_on_event(esp_mqtt_event_handle_t event) {
+    switch (event->event_id) {
+        case MQTT_EVENT_BEFORE_CONNECT:
+            if (timed) {
+                start_measurement();
+            }
+            break;
+
+        case MQTT_EVENT_CONNECTED:
+            finish_measurement(true);
+            break;
+
+        case MQTT_EVENT_DISCONNECTED:
+            finish_measurement(false);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void mqtt_tls_get_stats(mqtt_tls_stats_t *out) {
+    *out = stats;
+}
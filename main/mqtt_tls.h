@@ -0,0 +1,40 @@
+// mqtt_tls.h
+#ifndef MQTT_TLS_H
+#define MQTT_TLS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "static_mem.h"
+#include "esp_heap_caps.h"
+#include "esp_crt_bundle.h"
+#include "mqtt_client.h"
+
+// Heap sampling period while a connection attempt is in progress
+#define MQTT_TLS_HEAP_SAMPLE_US 2000
+
+typedef struct {
+    uint32_t connects;       // Completed connects
+    uint32_t failures;       // Connect attempts that never reached CONNECTED
+    uint32_t last_ms;        // Last connect time (TCP + TLS + MQTT CONNECT)
+    uint32_t min_ms;
+    uint32_t max_ms;
+    uint32_t last_heap_peak; // Bytes taken from the heap during the last connect
+    uint32_t max_heap_peak;
+} mqtt_tls_stats_t;
+
+// Create the connect heap sampler (before the client starts)
+void mqtt_tls_init(void);
+
+// Enable TLS for mqtts:// and wss:// URIs using the certificate bundle in flash
+void mqtt_tls_apply(esp_mqtt_client_config_t *cfg);
+
+// Feed MQTT events to time mqtts:// connects and track their heap peak
+void mqtt_tls_on_event(esp_mqtt_event_handle_t event);
+
+void mqtt_tls_get_stats(mqtt_tls_stats_t *stats);
+
+#endif // MQTT_TLS_H
@@ -0,0 +1,32 @@
+#include "net_state.h"
+
+static EventGroupHandle_t net_events = NULL;
+static StaticEventGroup_t net_events_buffer;
+
+void net_state_init(void) {
+    if (net_events == NULL) {
+        net_events = xEventGroupCreateStatic(&net_events_buffer);
+        configASSERT(net_events != NULL);
+    }
+}
+
+void net_state_set(EventBits_t bits) {
+    xEventGroupSetBits(net_events, bits);
+}
+
+void net_state_clear(EventBits_t bits) {
+    xEventGroupClearBits(net_events, bits);
+    if (bits & NET_GOT_IP) {
+        xEventGroupSetBits(net_events, NET_IP_LOST);
+    }
+}
+
+bool net_state_is(EventBits_t bits) {
+    return (xEventGroupGetBits(net_events) & bits) == bits;
+}
+
+bool net_state_wait(EventBits_t bits, uint32_t timeout_ms) {
+    TickType_t ticks = (timeout_ms == NET_WAIT_FOREVER) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    EventBits_t set = xEventGroupWaitBits(net_events, bits, pdFALSE, pdTRUE, ticks);
+    return (set & bits) == bits;
+}
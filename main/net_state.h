@@ -0,0 +1,31 @@
+// net_state.h
+#ifndef NET_STATE_H
+#define NET_STATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_bit_defs.h"
+
+// Connectivity bits, set and cleared by the WiFi, IP and MQTT event handlers
+#define NET_LINK_UP   BIT0 // Associated with an AP
+#define NET_GOT_IP    BIT1 // IP address assigned
+#define NET_BROKER_UP BIT2 // MQTT session established
+#define NET_IP_LOST   BIT3 // Latched when NET_GOT_IP is cleared; the MQTT task clears it
+
+#define NET_WAIT_FOREVER UINT32_MAX
+
+// Create the event group (call from app_main before any task starts)
+void net_state_init(void);
+
+void net_state_set(EventBits_t bits);
+void net_state_clear(EventBits_t bits);
+
+// True if all given bits are set
+bool net_state_is(EventBits_t bits);
+
+// Block until all given bits are set; returns false on timeout
+bool net_state_wait(EventBits_t bits, uint32_t timeout_ms);
+
+#endif // NET_STATE_H
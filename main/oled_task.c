@@ -83,6 +83,8 @@ static esp_err_t ssd1306_init(void) {
 
 // Update entire display
 static esp_err_t ssd1306_update_screen(void) {
+    PROFILER_SCOPE(PROFILER_SECTION_FRAME_PUSH);
+
     for (uint8_t page = 0; page < SSD1306_PAGES; page++) {
         // Set page and column address
         ssd1306_write_command(0xB0 + page);
@@ -135,8 +137,9 @@ static void ssd1306_draw_string_8x16(uint8_t x, uint8_t y, const char *str, cons
     }
 }
 
-// Update display with current sensor data
+// Render current sensor data into the frame buffer
 static void update_display_content(void) {
+    PROFILER_SCOPE(PROFILER_SECTION_FRAME_RENDER);
     char buffer[32];
     
     // Clear buffer
@@ -151,16 +154,17 @@ static void update_display_content(void) {
     ssd1306_draw_string_8x16(0, 16, buffer, ssd1306xled_font8x16);
     
     // Display WiFi status
-    const char* wifi_status = wifi_connected ? "WiFi: Connected" : "WiFi: Disconnected";
+    const char* wifi_status = net_state_is(NET_GOT_IP) ? "WiFi: Connected" : "WiFi: Disconnected";
     ssd1306_draw_string_8x16(0, 32, wifi_status, ssd1306xled_font8x16);
     
     // Display alarm status
     if (overheat_alarm) {
         ssd1306_draw_string_8x16(0, 48, "ALARM: OVERHEAT!", ssd1306xled_font8x16);
+    } else if (alarm_monitor_prealarm()) {
+        ssd1306_draw_string_8x16(0, 48, "PRE-ALARM RISING", ssd1306xled_font8x16);
+    } else if (alarm_monitor_level() == ALARM_LEVEL_WARNING) {
+        ssd1306_draw_string_8x16(0, 48, "WARN: HIGH TEMP", ssd1306xled_font8x16);
     }
-    
-    // Update screen
-    ssd1306_update_screen();
 }
 
 // Main OLED task
@@ -170,7 +174,7 @@ void oled_task(void *pvParameters) {
     // Initialize display
     if (ssd1306_init() != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize SSD1306 display");
-        vTaskDelete(NULL);
+        task_plan_exit(TASK_PLAN_OLED);
         return;
     }
     
@@ -180,6 +184,7 @@ void oled_task(void *pvParameters) {
     
     while (1) {
         update_display_content();
+        ssd1306_update_screen();
         vTaskDelay(pdMS_TO_TICKS(OLED_UPDATE_DELAY));
     }
 }
\ No newline at end of file
@@ -4,9 +4,13 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "global_data.h"
+#include "net_state.h"
+#include "alarm_monitor.h"
 #include "driver/i2c.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "profiler.h"
+#include "task_plan.h"
 #include <string.h>
 
 // SSD1306 display constants
@@ -0,0 +1,116 @@
+#include "power_save.h"
+
+static const char *TAG = "POWER_SAVE";
+
+static const uint16_t state_current_ma[POWER_STATE_COUNT] = {
+    [POWER_STATE_OFFLINE] = POWER_CURRENT_OFFLINE_MA,
+    [POWER_STATE_ACTIVE] = POWER_CURRENT_ACTIVE_MA,
+    [POWER_STATE_MODEM_SLEEP] = POWER_CURRENT_MODEM_SLEEP_MA,
+};
+
+static power_state_t current_state = POWER_STATE_OFFLINE;
+static int64_t state_since_us = 0;
+static uint64_t state_time_us[POWER_STATE_COUNT];
+static uint32_t tx_windows = 0;
+static bool link_up = false;
+static portMUX_TYPE power_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_timer_handle_t tail_timer = NULL;
+
+// State the radio settles in while associated and idle
+static power_state_t idle_state(void) {
+    return POWER_SAVE_ENABLE ? POWER_STATE_MODEM_SLEEP : POWER_STATE_ACTIVE;
+}
+
+// Close the current accounting interval (caller holds power_lock)
+static void enter_state_locked(power_state_t state) {
+    int64_t now = esp_timer_get_time();
+    state_time_us[current_state] += now - state_since_us;
+    state_since_us = now;
+    current_state = state;
+}
+
+// End of the post-transmission tail: back to sleep
+static void tail_timer_callback(void *arg) {
+    portENTER_CRITICAL(&power_lock);
+    if (link_up && current_state == POWER_STATE_ACTIVE) {
+        enter_state_locked(idle_state());
+    }
+    portEXIT_CRITICAL(&power_lock);
+}
+
+void power_save_init(void) {
+    const esp_timer_create_args_t args = {
+        .callback = tail_timer_callback,
+        .name = "power_tail"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&args, &tail_timer));
+    state_since_us = esp_timer_get_time();
+
+#if POWER_SAVE_ENABLE
+    ESP_ERROR_CHECK(esp_wifi_set_ps(WIFI_PS_MAX_MODEM));
+    ESP_LOGI(TAG, "Modem sleep enabled, listen interval %d beacons", WIFI_LISTEN_INTERVAL);
+#else
+    ESP_ERROR_CHECK(esp_wifi_set_ps(WIFI_PS_NONE));
+#endif
+}
+
+void power_save_on_link(bool up) {
+    portENTER_CRITICAL(&power_lock);
+    link_up = up;
+    enter_state_locked(up ? idle_state() : POWER_STATE_OFFLINE);
+    portEXIT_CRITICAL(&power_lock);
+}
+
+void power_save_on_tx(void) {
+    portENTER_CRITICAL(&power_lock);
+    if (link_up && current_state != POWER_STATE_ACTIVE) {
+        enter_state_locked(POWER_STATE_ACTIVE);
+        tx_windows++;
+    }
+    portEXIT_CRITICAL(&power_lock);
+
+    if (tail_timer != NULL && POWER_SAVE_ENABLE) {
+        esp_timer_stop(tail_timer);
+        esp_timer_start_once(tail_timer, POWER_TX_TAIL_MS * 1000);
+    }
+}
+
+int64_t power_save_tx_wait_us(void) {
+#if POWER_SAVE_ENABLE
+    // Windows sit on a fixed grid so every producer lands in the same wake
+    const int64_t period_us = (int64_t)POWER_TX_WINDOW_PERIOD_MS * 1000;
+    int64_t phase = esp_timer_get_time() % period_us;
+    return (phase < POWER_TX_WINDOW_OPEN_MS * 1000) ? 0 : period_us - phase;
+#else
+    return 0;
+#endif
+}
+
+void power_save_get_stats(power_save_stats_t *stats) {
+    uint64_t total_us = 0;
+    float charge = 0.0f;
+
+    portENTER_CRITICAL(&power_lock);
+    enter_state_locked(current_state);
+    for (int i = 0; i < POWER_STATE_COUNT; i++) {
+        stats->time_ms[i] = state_time_us[i] / 1000;
+        total_us += state_time_us[i];
+        charge += (float)state_time_us[i] * state_current_ma[i];
+    }
+    stats->tx_windows = tx_windows;
+    portEXIT_CRITICAL(&power_lock);
+
+    stats->avg_current_ma = (total_us > 0) ? charge / total_us : 0.0f;
+}
+
+const char *power_save_state_name(power_state_t state) {
+    switch (state) {
+        case POWER_STATE_ACTIVE:
+            return "active";
+        case POWER_STATE_MODEM_SLEEP:
+            return "modem_sleep";
+        default:
+            return "offline";
+    }
+}
@@ -0,0 +1,54 @@
+// power_save.h
+#ifndef POWER_SAVE_H
+#define POWER_SAVE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "static_mem.h"
+#include "esp_wifi.h"
+
+// Modem sleep: the radio wakes every WIFI_LISTEN_INTERVAL beacons (~102 ms each)
+#define POWER_SAVE_ENABLE 1
+#define WIFI_LISTEN_INTERVAL 3
+
+// Telemetry and bulk messages are held for a shared transmit window so one
+// radio wake carries the whole batch; alarms and state are never held
+#define POWER_TX_WINDOW_PERIOD_MS 2000
+#define POWER_TX_WINDOW_OPEN_MS 100
+#define POWER_TX_TAIL_MS 50 // Radio stays awake this long after a transmission
+
+// Typical ESP32 currents used to estimate the average draw (adjust per board)
+#define POWER_CURRENT_ACTIVE_MA 120
+#define POWER_CURRENT_MODEM_SLEEP_MA 30
+#define POWER_CURRENT_OFFLINE_MA 120 // Scanning and connecting keep the radio on
+
+typedef enum {
+    POWER_STATE_OFFLINE = 0, // No link
+    POWER_STATE_ACTIVE,      // Radio awake (transmitting, or power save disabled)
+    POWER_STATE_MODEM_SLEEP, // Associated, radio asleep between beacons
+    POWER_STATE_COUNT
+} power_state_t;
+
+typedef struct {
+    uint64_t time_ms[POWER_STATE_COUNT];
+    uint32_t tx_windows;    // Radio wakes caused by transmissions
+    float avg_current_ma;   // Estimate from the time split and the currents above
+} power_save_stats_t;
+
+// Enable modem sleep (call after esp_wifi_init)
+void power_save_init(void);
+
+// Accounting hooks: link up/down and every transmission
+void power_save_on_link(bool up);
+void power_save_on_tx(void);
+
+// Time until the next transmit window opens (0 = open now)
+int64_t power_save_tx_wait_us(void);
+
+void power_save_get_stats(power_save_stats_t *stats);
+const char *power_save_state_name(power_state_t state);
+
+#endif // POWER_SAVE_H
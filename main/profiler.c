@@ -0,0 +1,340 @@
+#include "profiler.h"
+#include "publish_scheduler.h"
+
+#define HISTORY_LEN (PROFILER_WINDOW_LONG_S * 1000 / PROFILER_SAMPLE_MS + 1)
+
+// Duration histogram: exact below 8 us, then 4 buckets per power of two
+#define HIST_MAX_US ((1u << 24) - 1)
+#define HIST_BUCKETS (8 + (24 - 3) * 4)
+
+#define REPORT_ENTRY_MAX 80 // Room kept for one more task or section entry
+
+static const char *TAG = "PROFILER";
+
+static const char *const section_names[PROFILER_SECTION_COUNT] = {
+    [PROFILER_SECTION_DHT_READ] = "dht_read",
+    [PROFILER_SECTION_FRAME_RENDER] = "frame_render",
+    [PROFILER_SECTION_FRAME_PUSH] = "frame_push",
+    [PROFILER_SECTION_PUBLISH] = "publish",
+    [PROFILER_SECTION_LOG] = "log",
+};
+
+typedef struct {
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[HIST_BUCKETS];
+} section_acc_t;
+
+// A task seen by the sampler; its counters sit in the same column of every snapshot
+typedef struct {
+    TaskHandle_t handle; // NULL = free
+    char name[configMAX_TASK_NAME_LEN];
+    int8_t core;
+    bool seen;
+} task_slot_t;
+
+typedef struct {
+    uint32_t total; // Run-time clock at the sample
+    uint32_t counter[PROFILER_MAX_TASKS];
+} snapshot_t;
+
+static section_acc_t sections[PROFILER_SECTION_COUNT];
+static portMUX_TYPE section_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static task_slot_t slots[PROFILER_MAX_TASKS];
+static snapshot_t history[HISTORY_LEN];
+static int head = 0;   // Newest snapshot
+static int filled = 0; // Valid snapshots
+static TaskStatus_t status[PROFILER_MAX_TASKS];
+static SemaphoreHandle_t cpu_mutex = NULL;
+static StaticSemaphore_t cpu_mutex_buffer;
+
+static esp_timer_handle_t sample_timer = NULL;
+static vprintf_like_t log_vprintf = NULL;
+static int samples_since_report = 0;
+
+static int bucket_of(uint32_t us) {
+    if (us > HIST_MAX_US) {
+        us = HIST_MAX_US;
+    }
+    if (us < 8) {
+        return (int)us;
+    }
+    int octave = 31 - __builtin_clz(us);
+    return 8 + (octave - 3) * 4 + (int)((us >> (octave - 2)) & 3);
+}
+
+// Largest duration that falls into a bucket
+static uint32_t bucket_upper(int bucket) {
+    if (bucket < 8) {
+        return (uint32_t)bucket;
+    }
+    int octave = (bucket - 8) / 4 + 3;
+    uint32_t step = 1u << (octave - 2);
+    return (uint32_t)(4 + (bucket - 8) % 4) * step + step - 1;
+}
+
+void profiler_record(profiler_section_t section, uint32_t us) {
+    section_acc_t *acc = &sections[section];
+    int bucket = bucket_of(us);
+
+    portENTER_CRITICAL(&section_lock);
+    if (acc->count == 0 || us < acc->min_us) {
+        acc->min_us = us;
+    }
+    if (us > acc->max_us) {
+        acc->max_us = us;
+    }
+    acc->count++;
+    acc->sum_us += us;
+    acc->buckets[bucket]++;
+    portEXIT_CRITICAL(&section_lock);
+}
+
+void profiler_scope_end(profiler_scope_t *scope) {
+    profiler_record(scope->section, (uint32_t)(esp_timer_get_time() - scope->start_us));
+}
+
+// ESP_LOG output hook: time formatting and the UART write
+static int timed_vprintf(const char *format, va_list args) {
+    int64_t start = esp_timer_get_time();
+    int ret = log_vprintf(format, args);
+
+    profiler_record(PROFILER_SECTION_LOG, (uint32_t)(esp_timer_get_time() - start));
+    return ret;
+}
+
+static void section_stats(const section_acc_t *acc, profiler_section_stats_t *out) {
+    uint32_t target = acc->count - acc->count / 100; // 99th percentile rank
+    uint32_t seen = 0;
+
+    out->count = acc->count;
+    out->min_us = acc->min_us;
+    out->max_us = acc->max_us;
+    out->avg_us = acc->count ? (uint32_t)(acc->sum_us / acc->count) : 0;
+    out->p99_us = 0;
+    for (int i = 0; i < HIST_BUCKETS && acc->count; i++) {
+        seen += acc->buckets[i];
+        if (seen >= target) {
+            out->p99_us = bucket_upper(i) < acc->max_us ? bucket_upper(i) : acc->max_us;
+            break;
+        }
+    }
+}
+
+// Copy (and optionally restart) the section statistics
+static void read_sections(profiler_section_stats_t out[PROFILER_SECTION_COUNT], bool reset) {
+    static section_acc_t copy[PROFILER_SECTION_COUNT];
+
+    portENTER_CRITICAL(&section_lock);
+    memcpy(copy, sections, sizeof(copy));
+    if (reset) {
+        memset(sections, 0, sizeof(sections));
+    }
+    portEXIT_CRITICAL(&section_lock);
+
+    for (int i = 0; i < PROFILER_SECTION_COUNT; i++) {
+        out[i].name = section_names[i];
+        section_stats(&copy[i], &out[i]);
+    }
+}
+
+// read_sections() works on a static copy, so callers hold cpu_mutex
+void profiler_get_sections(profiler_section_stats_t out[PROFILER_SECTION_COUNT]) {
+    xSemaphoreTake(cpu_mutex, portMAX_DELAY);
+    read_sections(out, false);
+    xSemaphoreGive(cpu_mutex);
+}
+
+static int find_slot(TaskHandle_t handle) {
+    for (int i = 0; i < PROFILER_MAX_TASKS; i++) {
+        if (slots[i].handle == handle) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Give a new task a column; its past counters read as no use
+static int assign_slot(const TaskStatus_t *task) {
+    int i = find_slot(NULL);
+
+    if (i < 0) {
+        return -1;
+    }
+    slots[i].handle = task->xHandle;
+    strncpy(slots[i].name, task->pcTaskName, sizeof(slots[i].name) - 1);
+    // Core from the snapshot: the task may have been deleted since, so its
+    // handle is never passed back to the kernel
+    slots[i].core = (task->xCoreID == tskNO_AFFINITY) ? -1 : (int8_t)task->xCoreID;
+    for (int s = 0; s < HISTORY_LEN; s++) {
+        history[s].counter[i] = task->ulRunTimeCounter;
+    }
+    return i;
+}
+
+// Record one snapshot of every task's run-time counter (caller holds cpu_mutex)
+static void take_sample(void) {
+    uint32_t total = 0;
+    UBaseType_t count = uxTaskGetSystemState(status, PROFILER_MAX_TASKS, &total);
+
+    if (count == 0) {
+        return; // More tasks than PROFILER_MAX_TASKS
+    }
+
+    int next = filled ? (head + 1) % HISTORY_LEN : 0;
+    snapshot_t *snap = &history[next];
+
+    for (int i = 0; i < PROFILER_MAX_TASKS; i++) {
+        slots[i].seen = false;
+    }
+    for (UBaseType_t t = 0; t < count; t++) {
+        int i = find_slot(status[t].xHandle);
+        if (i < 0 && (i = assign_slot(&status[t])) < 0) {
+            continue;
+        }
+        slots[i].seen = true;
+        snap->counter[i] = status[t].ulRunTimeCounter;
+    }
+    // Deleted tasks free their column
+    for (int i = 0; i < PROFILER_MAX_TASKS; i++) {
+        if (!slots[i].seen) {
+            slots[i].handle = NULL;
+        }
+    }
+
+    snap->total = total;
+    head = next;
+    if (filled < HISTORY_LEN) {
+        filled++;
+    }
+}
+
+// Oldest snapshot of a window (the window is shorter until history fills)
+static const snapshot_t *window_start(int window_s) {
+    int back = window_s * 1000 / PROFILER_SAMPLE_MS;
+
+    if (back > filled - 1) {
+        back = filled - 1;
+    }
+    return &history[(head - back + HISTORY_LEN) % HISTORY_LEN];
+}
+
+static uint16_t permille(uint32_t part, uint32_t whole) {
+    uint32_t value = whole ? (uint32_t)((uint64_t)part * 1000 / whole) : 0;
+    return value > 1000 ? 1000 : (uint16_t)value;
+}
+
+void profiler_get_cpu(profiler_cpu_t *out) {
+    const int windows[2] = { PROFILER_WINDOW_SHORT_S, PROFILER_WINDOW_LONG_S };
+
+    memset(out, 0, sizeof(*out));
+    xSemaphoreTake(cpu_mutex, portMAX_DELAY);
+    if (filled < 2) {
+        xSemaphoreGive(cpu_mutex);
+        return;
+    }
+
+    const snapshot_t *now = &history[head];
+    for (int i = 0; i < PROFILER_MAX_TASKS; i++) {
+        if (slots[i].handle == NULL) {
+            continue;
+        }
+        profiler_task_usage_t *task = &out->tasks[out->task_count++];
+        strncpy(task->name, slots[i].name, sizeof(task->name) - 1);
+        task->core = slots[i].core;
+        for (int w = 0; w < 2; w++) {
+            const snapshot_t *start = window_start(windows[w]);
+            task->permille[w] = permille(now->counter[i] - start->counter[i], now->total - start->total);
+        }
+    }
+    for (int w = 0; w < 2; w++) {
+        const snapshot_t *start = window_start(windows[w]);
+        out->window_ms[w] = (now->total - start->total) / 1000;
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            int idle = find_slot(xTaskGetIdleTaskHandleForCPU(core));
+            uint16_t idle_permille = idle < 0 ? 0 :
+                permille(now->counter[idle] - start->counter[idle], now->total - start->total);
+            out->core_busy_permille[core][w] = 1000 - idle_permille;
+        }
+    }
+    xSemaphoreGive(cpu_mutex);
+
+    // Busiest first over the long window
+    for (size_t i = 1; i < out->task_count; i++) {
+        profiler_task_usage_t task = out->tasks[i];
+        size_t j = i;
+        while (j > 0 && out->tasks[j - 1].permille[1] < task.permille[1]) {
+            out->tasks[j] = out->tasks[j - 1];
+            j--;
+        }
+        out->tasks[j] = task;
+    }
+}
+
+// Two messages on FEED_CPU: busiest tasks and per-core load, then sections
+static void publish_report(void) {
+    static profiler_cpu_t cpu;
+    profiler_section_stats_t stats[PROFILER_SECTION_COUNT];
+    char payload[PUBLISH_PAYLOAD_MAX];
+    int len;
+
+    profiler_get_cpu(&cpu);
+    len = snprintf(payload, sizeof(payload), "{\"win\":%u,\"core\":[",
+                   (unsigned)(cpu.window_ms[1] / 1000));
+    for (int core = 0; core < portNUM_PROCESSORS; core++) {
+        len += snprintf(payload + len, sizeof(payload) - len, "%s%u", core ? "," : "",
+                        cpu.core_busy_permille[core][1]);
+    }
+    len += snprintf(payload + len, sizeof(payload) - len, "],\"task\":[");
+    for (size_t i = 0; i < cpu.task_count && i < PROFILER_MQTT_TOP_TASKS &&
+                       len < (int)sizeof(payload) - REPORT_ENTRY_MAX; i++) {
+        len += snprintf(payload + len, sizeof(payload) - len, "%s[\"%s\",%d,%u]", i ? "," : "",
+                        cpu.tasks[i].name, cpu.tasks[i].core, cpu.tasks[i].permille[1]);
+    }
+    len += snprintf(payload + len, sizeof(payload) - len, "]}");
+    publish_scheduler_submit(FEED_CPU, payload, len, 0, 0, PUBLISH_PRIO_BULK);
+
+    xSemaphoreTake(cpu_mutex, portMAX_DELAY);
+    read_sections(stats, true);
+    xSemaphoreGive(cpu_mutex);
+    len = snprintf(payload, sizeof(payload), "{\"sec\":[");
+    for (int i = 0; i < PROFILER_SECTION_COUNT &&
+                    len < (int)sizeof(payload) - REPORT_ENTRY_MAX; i++) {
+        len += snprintf(payload + len, sizeof(payload) - len, "%s[\"%s\",%u,%u,%u,%u,%u]",
+                        i ? "," : "", stats[i].name, (unsigned)stats[i].count,
+                        (unsigned)stats[i].min_us, (unsigned)stats[i].avg_us,
+                        (unsigned)stats[i].max_us, (unsigned)stats[i].p99_us);
+    }
+    len += snprintf(payload + len, sizeof(payload) - len, "]}");
+    publish_scheduler_submit(FEED_CPU, payload, len, 0, 0, PUBLISH_PRIO_BULK);
+}
+
+static void sample_timer_callback(void *arg) {
+    xSemaphoreTake(cpu_mutex, portMAX_DELAY);
+    take_sample();
+    xSemaphoreGive(cpu_mutex);
+
+    if (++samples_since_report >= PROFILER_REPORT_MS / PROFILER_SAMPLE_MS) {
+        samples_since_report = 0;
+        publish_report();
+    }
+}
+
+void profiler_init(void) {
+    cpu_mutex = xSemaphoreCreateMutexStatic(&cpu_mutex_buffer);
+    log_vprintf = esp_log_set_vprintf(timed_vprintf);
+
+#if !CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    ESP_LOGW(TAG, "Run-time stats disabled, CPU use reads as zero");
+#endif
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = sample_timer_callback,
+        .name = "profiler"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&timer_args, &sample_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(sample_timer, PROFILER_SAMPLE_MS * 1000));
+}
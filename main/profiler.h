@@ -0,0 +1,89 @@
+// profiler.h
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdkconfig.h"
+#include "global_data.h"
+#include "static_mem.h"
+
+// CPU use per task from the FreeRTOS run-time counters (1 us esp_timer
+// clock, CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS and
+// CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID in sdkconfig.defaults), over a
+// short and a long sliding window
+#define PROFILER_SAMPLE_MS 2000
+#define PROFILER_WINDOW_SHORT_S 10
+#define PROFILER_WINDOW_LONG_S 60
+#define PROFILER_MAX_TASKS 32      // Sampling pauses if the system has more
+#define PROFILER_REPORT_MS 60000   // CPU and section report on FEED_CPU
+#define PROFILER_MQTT_TOP_TASKS 6  // Busiest tasks in the MQTT report
+
+// Named hot sections
+typedef enum {
+    PROFILER_SECTION_DHT_READ = 0,
+    PROFILER_SECTION_FRAME_RENDER,
+    PROFILER_SECTION_FRAME_PUSH,
+    PROFILER_SECTION_PUBLISH,
+    PROFILER_SECTION_LOG, // Every ESP_LOG line (formatting and UART)
+    PROFILER_SECTION_COUNT
+} profiler_section_t;
+
+typedef struct {
+    profiler_section_t section;
+    int64_t start_us;
+} profiler_scope_t;
+
+void profiler_scope_end(profiler_scope_t *scope);
+
+#define PROFILER_CONCAT_(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_(a, b)
+
+// Time from here to the end of the enclosing block as one sample of section
+#define PROFILER_SCOPE(section) \
+    profiler_scope_t PROFILER_CONCAT(profiler_scope_, __LINE__) \
+        __attribute__((cleanup(profiler_scope_end))) = { (section), esp_timer_get_time() }
+
+// Add one duration sample (any task, cheap: a spinlock and a histogram bucket)
+void profiler_record(profiler_section_t section, uint32_t us);
+
+typedef struct {
+    const char *name;
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t avg_us;
+    uint32_t max_us;
+    uint32_t p99_us; // Histogram bucket bound, within 25%
+} profiler_section_stats_t;
+
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    int core;             // -1 if the task may run on either core
+    uint16_t permille[2]; // Share of one core, short and long window
+} profiler_task_usage_t;
+
+typedef struct {
+    uint32_t window_ms[2]; // Actual spans (shorter right after boot)
+    uint16_t core_busy_permille[portNUM_PROCESSORS][2];
+    profiler_task_usage_t tasks[PROFILER_MAX_TASKS]; // Busiest first (long window)
+    size_t task_count;
+} profiler_cpu_t;
+
+// Start sampling and time log output (before the tasks are created)
+void profiler_init(void);
+
+void profiler_get_cpu(profiler_cpu_t *out);
+
+// Section statistics since the last MQTT report
+void profiler_get_sections(profiler_section_stats_t out[PROFILER_SECTION_COUNT]);
+
+#endif // PROFILER_H
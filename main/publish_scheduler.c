@@ -0,0 +1,252 @@
+#include "publish_scheduler.h"
+
+#define PUBLISH_RETRY_DELAY_MS 1000
+
+static const char *TAG = "PUBLISH_SCHED";
+
+typedef struct {
+    bool pending;
+    const char *topic;
+    char payload[PUBLISH_PAYLOAD_MAX];
+    int len;
+    int qos;
+    int retain;
+    publish_priority_t prio;
+    uint32_t seq;     // Queue order, kept when coalescing
+    uint32_t version; // Bumped on every write
+} publish_slot_t;
+
+static publish_slot_t slots[PUBLISH_SLOT_COUNT];
+static portMUX_TYPE slots_lock = portMUX_INITIALIZER_UNLOCKED;
+static uint32_t next_seq = 0;
+static publish_scheduler_stats_t stats;
+
+static esp_mqtt_client_handle_t active_client = NULL;
+static TaskHandle_t scheduler_task_handle = NULL;
+
+// Token bucket state (only touched by the scheduler task)
+static float tokens = PUBLISH_BUCKET_BURST;
+static int64_t last_refill_us = 0;
+
+// Minimum bucket level each class needs before it may send
+static const float min_tokens[PUBLISH_PRIO_COUNT] = {
+    [PUBLISH_PRIO_ALARM] = 1.0f,
+    [PUBLISH_PRIO_STATE] = 1.0f + PUBLISH_ALARM_RESERVE,
+    [PUBLISH_PRIO_TELEMETRY] = 1.0f + PUBLISH_ALARM_RESERVE,
+    [PUBLISH_PRIO_BULK] = PUBLISH_BUCKET_BURST, // Bulk only drains an idle bucket
+};
+
+// Wake the scheduler task if it is running
+static void wake_scheduler(void) {
+    if (scheduler_task_handle != NULL) {
+        xTaskNotifyGive(scheduler_task_handle);
+    }
+}
+
+// Add tokens for the time elapsed since the last refill
+static void refill_tokens(void) {
+    int64_t now = esp_timer_get_time();
+
+    if (last_refill_us != 0) {
+        tokens += (float)(now - last_refill_us) * PUBLISH_RATE_PER_MINUTE / 60000000.0f;
+        if (tokens > PUBLISH_BUCKET_BURST) {
+            tokens = PUBLISH_BUCKET_BURST;
+        }
+    }
+    last_refill_us = now;
+}
+
+// Find a slot for a new message (caller holds slots_lock)
+static publish_slot_t *find_slot(const char *topic, publish_priority_t prio, bool *coalesced) {
+    publish_slot_t *free_slot = NULL;
+    publish_slot_t *victim = NULL;
+
+    for (int i = 0; i < PUBLISH_SLOT_COUNT; i++) {
+        publish_slot_t *slot = &slots[i];
+
+        if (!slot->pending) {
+            if (free_slot == NULL) {
+                free_slot = slot;
+            }
+            continue;
+        }
+        // Alarm and bulk messages each carry distinct data and are never coalesced
+        if (prio != PUBLISH_PRIO_ALARM && prio != PUBLISH_PRIO_BULK &&
+            slot->prio != PUBLISH_PRIO_ALARM && slot->prio != PUBLISH_PRIO_BULK &&
+            (slot->topic == topic || strcmp(slot->topic, topic) == 0)) {
+            *coalesced = true;
+            return slot;
+        }
+        // Lowest priority, oldest message is evicted when full
+        if (slot->prio > prio &&
+            (victim == NULL || slot->prio > victim->prio ||
+             (slot->prio == victim->prio && slot->seq < victim->seq))) {
+            victim = slot;
+        }
+    }
+
+    return free_slot != NULL ? free_slot : victim;
+}
+
+// Pick the highest priority, oldest pending slot (caller holds slots_lock)
+static int select_next_slot(void) {
+    int best = -1;
+
+    for (int i = 0; i < PUBLISH_SLOT_COUNT; i++) {
+        if (!slots[i].pending) {
+            continue;
+        }
+        if (best < 0 || slots[i].prio < slots[best].prio ||
+            (slots[i].prio == slots[best].prio && slots[i].seq < slots[best].seq)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+bool publish_scheduler_submit(const char *topic, const char *payload, int len,
+                              int qos, int retain, publish_priority_t prio) {
+    if (len <= 0) {
+        len = strlen(payload);
+    }
+    if (len > PUBLISH_PAYLOAD_MAX) {
+        ESP_LOGE(TAG, "Payload too large for %s (%d bytes)", topic, len);
+        return false;
+    }
+
+    bool coalesced = false;
+    bool evicted = false;
+
+    portENTER_CRITICAL(&slots_lock);
+    publish_slot_t *slot = find_slot(topic, prio, &coalesced);
+    if (slot != NULL) {
+        if (coalesced) {
+            stats.coalesced++;
+            if (prio < slot->prio) {
+                slot->prio = prio;
+            }
+        } else {
+            evicted = slot->pending;
+            if (evicted) {
+                stats.dropped++;
+            }
+            slot->prio = prio;
+            slot->seq = next_seq++;
+        }
+        slot->topic = topic;
+        memcpy(slot->payload, payload, len);
+        slot->len = len;
+        slot->qos = qos;
+        slot->retain = retain;
+        slot->version++;
+        slot->pending = true;
+    } else {
+        stats.dropped++;
+    }
+    portEXIT_CRITICAL(&slots_lock);
+
+    if (slot == NULL) {
+        ESP_LOGW(TAG, "Queue full, dropped message for %s", topic);
+        return false;
+    }
+    if (evicted) {
+        ESP_LOGW(TAG, "Queue full, evicted lower priority message for %s", topic);
+    }
+
+    wake_scheduler();
+    return true;
+}
+
+void publish_scheduler_set_client(esp_mqtt_client_handle_t client) {
+    active_client = client;
+    wake_scheduler();
+}
+
+void publish_scheduler_get_stats(publish_scheduler_stats_t *out) {
+    portENTER_CRITICAL(&slots_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&slots_lock);
+}
+
+// Send the next eligible message; returns ticks to wait before the next attempt
+static TickType_t service_queue(void) {
+    static publish_slot_t msg;
+    esp_mqtt_client_handle_t client = active_client;
+
+    if (client == NULL) {
+        return portMAX_DELAY;
+    }
+
+    portENTER_CRITICAL(&slots_lock);
+    int index = select_next_slot();
+    if (index >= 0) {
+        msg = slots[index];
+    }
+    portEXIT_CRITICAL(&slots_lock);
+
+    if (index < 0) {
+        return portMAX_DELAY;
+    }
+
+    // Telemetry and bulk wait for the shared transmit window
+    if (msg.prio >= PUBLISH_PRIO_TELEMETRY) {
+        int64_t window_us = power_save_tx_wait_us();
+        if (window_us > 0) {
+            return pdMS_TO_TICKS(window_us / 1000) + 1;
+        }
+    }
+
+    refill_tokens();
+    float needed = min_tokens[msg.prio];
+    if (tokens < needed) {
+        uint32_t wait_ms = (uint32_t)((needed - tokens) * 60000.0f / PUBLISH_RATE_PER_MINUTE) + 1;
+        stats.throttled++;
+        ESP_LOGD(TAG, "Rate limited, next send in %u ms", wait_ms);
+        return pdMS_TO_TICKS(wait_ms);
+    }
+
+    int64_t sent_us = esp_timer_get_time();
+    int msg_id;
+    {
+        PROFILER_SCOPE(PROFILER_SECTION_PUBLISH);
+        msg_id = esp_mqtt_client_publish(client, msg.topic, msg.payload,
+                                          msg.len, msg.qos, msg.retain);
+    }
+    if (msg_id < 0) {
+        stats.failed++;
+        ESP_LOGW(TAG, "Publish to %s failed, retrying", msg.topic);
+        return pdMS_TO_TICKS(PUBLISH_RETRY_DELAY_MS);
+    }
+    tokens -= 1.0f;
+    power_save_on_tx();
+    if (msg.qos > 0) {
+        broker_manager_on_publish(msg_id, sent_us);
+    }
+    if (msg.prio == PUBLISH_PRIO_ALARM) {
+        mqtt_bench_on_alarm_sent(msg_id);
+    }
+
+    portENTER_CRITICAL(&slots_lock);
+    // Keep the slot if a newer payload superseded it while publishing
+    if (slots[index].version == msg.version) {
+        slots[index].pending = false;
+    }
+    stats.sent++;
+    portEXIT_CRITICAL(&slots_lock);
+
+    return 0;
+}
+
+// Main publish scheduler task
+void publish_scheduler_task(void *param) {
+    scheduler_task_handle = xTaskGetCurrentTaskHandle();
+    ESP_LOGI(TAG, "Publish scheduler started (%d msg/min, burst %d)",
+             PUBLISH_RATE_PER_MINUTE, PUBLISH_BUCKET_BURST);
+
+    while (1) {
+        TickType_t wait = service_queue();
+        if (wait > 0) {
+            ulTaskNotifyTake(pdTRUE, wait);
+        }
+    }
+}
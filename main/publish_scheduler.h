@@ -0,0 +1,57 @@
+// publish_scheduler.h
+#ifndef PUBLISH_SCHEDULER_H
+#define PUBLISH_SCHEDULER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "mqtt_client.h"
+#include "broker_manager.h"
+#include "power_save.h"
+#include "mqtt_bench.h"
+#include "profiler.h"
+
+// Broker quota (Adafruit IO free tier: 30 data points per minute)
+#define PUBLISH_RATE_PER_MINUTE 30
+#define PUBLISH_BUCKET_BURST 5
+#define PUBLISH_ALARM_RESERVE 1 // Tokens only alarms may spend
+
+// Pending message storage
+#define PUBLISH_SLOT_COUNT 12
+#define PUBLISH_PAYLOAD_MAX 256
+
+// Priority classes, highest first
+typedef enum {
+    PUBLISH_PRIO_ALARM = 0,
+    PUBLISH_PRIO_STATE,
+    PUBLISH_PRIO_TELEMETRY,
+    PUBLISH_PRIO_BULK,
+    PUBLISH_PRIO_COUNT
+} publish_priority_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t coalesced;
+    uint32_t dropped;
+    uint32_t throttled;
+    uint32_t failed;
+} publish_scheduler_stats_t;
+
+// Queue a message. The topic string must outlive the message (config or
+// literal); a pending message on the same topic is replaced, not duplicated
+// (except for bulk messages, which are always queued).
+bool publish_scheduler_submit(const char *topic, const char *payload, int len,
+                              int qos, int retain, publish_priority_t prio);
+
+// Set the connected client (NULL while disconnected holds all traffic)
+void publish_scheduler_set_client(esp_mqtt_client_handle_t client);
+
+void publish_scheduler_get_stats(publish_scheduler_stats_t *stats);
+
+void publish_scheduler_task(void *param);
+
+#endif // PUBLISH_SCHEDULER_H
@@ -0,0 +1,308 @@
+#include "rule_engine.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RULE_FLAG_PENDING 0x01 // since_ms is the start of a run of true conditions
+#define RULE_FLAG_ACTIVE 0x02
+#define RULE_FLAG_PRIMED 0x04  // last_value/last_ms hold a sample
+
+#define RULE_NUMBER_MAX_LEN 16
+#define RULE_HOLD_MAX_S 86400
+
+#define ARRAY_LEN(a) (sizeof(a) / sizeof((a)[0]))
+
+typedef struct {
+    const char *p;
+    const char *end;
+} rule_cursor_t;
+
+static const char *const source_names[RULE_SOURCE_COUNT] = { "temp", "hum" };
+static const char *const op_names[] = { ">", "<", "rise", "fall", "silent" };
+static const char *const action_names[] = { "buzzer", "led1", "led2", "mqtt" }; // Bit order
+
+static bool is_rule_end(char c) {
+    return c == ';' || c == '\n' || c == '\0';
+}
+
+static bool is_blank(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Next word of the current rule; ',' is a token of its own
+static bool next_token(rule_cursor_t *c, const char **tok, size_t *len) {
+    while (c->p < c->end && is_blank(*c->p)) {
+        c->p++;
+    }
+    if (c->p >= c->end || is_rule_end(*c->p)) {
+        return false;
+    }
+
+    *tok = c->p;
+    if (*c->p == ',') {
+        c->p++;
+    } else {
+        while (c->p < c->end && !is_rule_end(*c->p) && !is_blank(*c->p) && *c->p != ',') {
+            c->p++;
+        }
+    }
+    *len = (size_t)(c->p - *tok);
+    return true;
+}
+
+static bool token_is(const char *tok, size_t len, const char *word) {
+    return strlen(word) == len && memcmp(tok, word, len) == 0;
+}
+
+// Index of the token in a name table, or -1
+static int token_index(const char *tok, size_t len, const char *const *names, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (token_is(tok, len, names[i])) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static bool next_number(rule_cursor_t *c, float *out) {
+    const char *tok;
+    size_t len;
+    char buf[RULE_NUMBER_MAX_LEN];
+    char *end;
+
+    if (!next_token(c, &tok, &len) || len >= sizeof(buf)) {
+        return false;
+    }
+    memcpy(buf, tok, len);
+    buf[len] = '\0';
+    *out = strtof(buf, &end);
+    return end == buf + len;
+}
+
+// Parse one rule, up to its ';' or newline
+static bool parse_rule(rule_cursor_t *c, rule_t *rule) {
+    const char *tok;
+    size_t len;
+    int index;
+    float hold_s;
+
+    memset(rule, 0, sizeof(*rule));
+    if (!next_token(c, &tok, &len)) {
+        return false;
+    }
+
+    // Condition
+    if (token_is(tok, len, "silent")) {
+        rule->op = RULE_OP_SILENT;
+        if (!next_number(c, &rule->threshold) || rule->threshold <= 0.0f) {
+            return false;
+        }
+    } else {
+        if ((index = token_index(tok, len, source_names, RULE_SOURCE_COUNT)) < 0) {
+            return false;
+        }
+        rule->source = (uint8_t)index;
+        if (!next_token(c, &tok, &len) ||
+            (index = token_index(tok, len, op_names, RULE_OP_SILENT)) < 0) {
+            return false;
+        }
+        rule->op = (uint8_t)index;
+        if (!next_number(c, &rule->threshold)) {
+            return false;
+        }
+    }
+
+    // Optional hold time
+    if (!next_token(c, &tok, &len)) {
+        return false;
+    }
+    if (token_is(tok, len, "for")) {
+        if (!next_number(c, &hold_s) || hold_s < 0.0f || hold_s > RULE_HOLD_MAX_S) {
+            return false;
+        }
+        rule->hold_ms = (uint32_t)(hold_s * 1000.0f);
+        if (!next_token(c, &tok, &len)) {
+            return false;
+        }
+    }
+
+    // Actions
+    if (!token_is(tok, len, "->")) {
+        return false;
+    }
+    while (next_token(c, &tok, &len)) {
+        if (token_is(tok, len, ",")) {
+            continue;
+        }
+        if ((index = token_index(tok, len, action_names, ARRAY_LEN(action_names))) < 0) {
+            return false;
+        }
+        rule->actions |= (uint8_t)(1u << index);
+    }
+    return rule->actions != 0;
+}
+
+int rule_engine_compile(rule_engine_t *engine, const char *table, size_t len) {
+    rule_cursor_t c = { table, table + len };
+
+    memset(engine, 0, sizeof(*engine));
+    while (c.p < c.end && *c.p != '\0') {
+        const char *start = c.p;
+
+        if (is_blank(*c.p) || *c.p == ';' || *c.p == '\n') {
+            c.p++;
+            continue;
+        }
+        if (engine->count == RULE_ENGINE_MAX_RULES ||
+            !parse_rule(&c, &engine->rules[engine->count])) {
+            engine->count = 0;
+            return -1 - (int)(start - table);
+        }
+        engine->count++;
+    }
+    return (int)engine->count;
+}
+
+// Track a condition over time; true once it has held for hold_ms
+static bool condition_holds(rule_state_t *st, bool cond, uint32_t now, uint32_t hold_ms) {
+    if (!cond) {
+        st->flags &= ~RULE_FLAG_PENDING;
+        return false;
+    }
+    if (!(st->flags & RULE_FLAG_PENDING)) {
+        st->flags |= RULE_FLAG_PENDING;
+        st->since_ms = now;
+    }
+    return now - st->since_ms >= hold_ms;
+}
+
+// Exponentially smoothed rate of change in units per minute
+static float update_rate(rule_state_t *st, float value, uint32_t now) {
+    if (st->flags & RULE_FLAG_PRIMED) {
+        uint32_t dt = now - st->last_ms;
+        if (dt > 0) {
+            float instant = (value - st->last_value) * 60000.0f / (float)dt;
+            float alpha = (float)dt / (float)(RULE_RATE_TAU_MS + dt);
+            st->rate += alpha * (instant - st->rate);
+        }
+    } else {
+        st->flags |= RULE_FLAG_PRIMED;
+        st->rate = 0.0f;
+    }
+    st->last_value = value;
+    st->last_ms = now;
+    return st->rate;
+}
+
+// Report a rule whose firing state changed
+static void set_active(rule_engine_t *engine, size_t i, bool fire, float value,
+                       rule_change_cb_t cb, void *ctx) {
+    rule_state_t *st = &engine->state[i];
+
+    if (fire == ((st->flags & RULE_FLAG_ACTIVE) != 0)) {
+        return;
+    }
+    st->flags ^= RULE_FLAG_ACTIVE;
+    if (cb) {
+        cb(i, &engine->rules[i], fire, value, ctx);
+    }
+}
+
+static void eval_silent(rule_engine_t *engine, size_t i, uint32_t now,
+                        rule_change_cb_t cb, void *ctx) {
+    const rule_t *rule = &engine->rules[i];
+    float silent_s = (float)(now - engine->last_valid_ms) / 1000.0f;
+    bool cond = silent_s >= rule->threshold;
+
+    set_active(engine, i, condition_holds(&engine->state[i], cond, now, rule->hold_ms),
+               silent_s, cb, ctx);
+}
+
+// Silent rules count from the first evaluation until a valid sample arrives
+static void start_clock(rule_engine_t *engine, uint32_t now) {
+    if (!engine->started) {
+        engine->started = true;
+        engine->last_valid_ms = now;
+    }
+}
+
+void rule_engine_eval(rule_engine_t *engine, const rule_sample_t *sample,
+                      rule_change_cb_t cb, void *ctx) {
+    uint32_t now = sample->time_ms;
+
+    start_clock(engine, now);
+    if (sample->valid) {
+        engine->last_valid_ms = now;
+    }
+
+    for (size_t i = 0; i < engine->count; i++) {
+        const rule_t *rule = &engine->rules[i];
+        rule_state_t *st = &engine->state[i];
+        float value;
+        bool cond;
+
+        if (rule->op == RULE_OP_SILENT) {
+            eval_silent(engine, i, now, cb, ctx);
+            continue;
+        }
+        // Failed reads carry no value; keep the current state
+        if (!sample->valid) {
+            continue;
+        }
+
+        value = sample->value[rule->source];
+        switch (rule->op) {
+            case RULE_OP_ABOVE:
+                cond = value > rule->threshold;
+                break;
+            case RULE_OP_BELOW:
+                cond = value < rule->threshold;
+                break;
+            case RULE_OP_RISE:
+                value = update_rate(st, value, now);
+                cond = value >= rule->threshold;
+                break;
+            default: // RULE_OP_FALL
+                value = update_rate(st, value, now);
+                cond = -value >= rule->threshold;
+                break;
+        }
+        set_active(engine, i, condition_holds(st, cond, now, rule->hold_ms), value, cb, ctx);
+    }
+}
+
+void rule_engine_tick(rule_engine_t *engine, uint32_t now_ms,
+                      rule_change_cb_t cb, void *ctx) {
+    start_clock(engine, now_ms);
+    for (size_t i = 0; i < engine->count; i++) {
+        if (engine->rules[i].op == RULE_OP_SILENT) {
+            eval_silent(engine, i, now_ms, cb, ctx);
+        }
+    }
+}
+
+bool rule_engine_is_active(const rule_engine_t *engine, size_t index) {
+    return index < engine->count && (engine->state[index].flags & RULE_FLAG_ACTIVE);
+}
+
+int rule_format(const rule_t *rule, char *out, size_t out_size) {
+    char hold[24] = "";
+    char actions[40] = "";
+    size_t used = 0;
+
+    if (rule->hold_ms) {
+        snprintf(hold, sizeof(hold), " for %g", rule->hold_ms / 1000.0);
+    }
+    for (size_t i = 0; i < ARRAY_LEN(action_names); i++) {
+        if (rule->actions & (1u << i)) {
+            used += snprintf(actions + used, sizeof(actions) - used, "%s%s",
+                             used ? "," : "", action_names[i]);
+        }
+    }
+
+    if (rule->op == RULE_OP_SILENT) {
+        return snprintf(out, out_size, "silent %g%s -> %s", rule->threshold, hold, actions);
+    }
+    return snprintf(out, out_size, "%s %s %g%s -> %s", source_names[rule->source],
+                    op_names[rule->op], rule->threshold, hold, actions);
+}
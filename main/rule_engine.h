@@ -0,0 +1,94 @@
+// rule_engine.h
+#ifndef RULE_ENGINE_H
+#define RULE_ENGINE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Rule table text, one rule per line or ';':
+//   <temp|hum> <>|<> <value> [for <seconds>] -> <actions>
+//   <temp|hum> <rise|fall> <units per minute> [for <seconds>] -> <actions>
+//   silent <seconds> -> <actions>
+// actions: comma-separated buzzer, led1, led2, mqtt
+// e.g. "hum > 80 for 300 -> mqtt; temp rise 2 for 60 -> led2,mqtt; silent 30 -> buzzer"
+#ifndef RULE_ENGINE_MAX_RULES
+#define RULE_ENGINE_MAX_RULES 32
+#endif
+#define RULE_RATE_TAU_MS 60000 // Smoothing time constant of rise/fall rates
+
+typedef enum {
+    RULE_SOURCE_TEMPERATURE = 0,
+    RULE_SOURCE_HUMIDITY,
+    RULE_SOURCE_COUNT
+} rule_source_t;
+
+typedef enum {
+    RULE_OP_ABOVE = 0,
+    RULE_OP_BELOW,
+    RULE_OP_RISE,   // Rate in units per minute at or above threshold
+    RULE_OP_FALL,
+    RULE_OP_SILENT  // No valid sample for threshold seconds
+} rule_op_t;
+
+#define RULE_ACTION_BUZZER 0x01
+#define RULE_ACTION_LED1 0x02
+#define RULE_ACTION_LED2 0x04
+#define RULE_ACTION_MQTT 0x08
+
+// Compiled rule (flat, evaluated in table order)
+typedef struct {
+    uint8_t op;
+    uint8_t source;
+    uint8_t actions;
+    float threshold;
+    uint32_t hold_ms; // Condition must hold this long before the rule fires
+} rule_t;
+
+// Per-rule evaluation state, constant size whatever the window
+typedef struct {
+    uint32_t since_ms;   // Start of the current run of true conditions
+    uint32_t last_ms;    // Previous sample (rate rules)
+    float last_value;
+    float rate;          // Smoothed units per minute
+    uint8_t flags;
+} rule_state_t;
+
+typedef struct {
+    rule_t rules[RULE_ENGINE_MAX_RULES];
+    rule_state_t state[RULE_ENGINE_MAX_RULES];
+    size_t count;
+    uint32_t last_valid_ms; // Reference of silent rules
+    bool started;
+} rule_engine_t;
+
+// One sensor reading in engine time (any monotonic millisecond clock)
+typedef struct {
+    uint32_t time_ms;
+    float value[RULE_SOURCE_COUNT];
+    bool valid;
+} rule_sample_t;
+
+// Called when a rule starts or stops firing; value is the reading (or rate,
+// or silent seconds) that caused the change
+typedef void (*rule_change_cb_t)(size_t index, const rule_t *rule, bool active,
+                                 float value, void *ctx);
+
+// Compile a rule table into engine (state reset). Returns the rule count,
+// or -1 - offset of the first invalid rule (engine left empty).
+int rule_engine_compile(rule_engine_t *engine, const char *table, size_t len);
+
+// Evaluate every rule against one sample
+void rule_engine_eval(rule_engine_t *engine, const rule_sample_t *sample,
+                      rule_change_cb_t cb, void *ctx);
+
+// Evaluate time-only rules (silent) without a sample
+void rule_engine_tick(rule_engine_t *engine, uint32_t now_ms,
+                      rule_change_cb_t cb, void *ctx);
+
+bool rule_engine_is_active(const rule_engine_t *engine, size_t index);
+
+// Print a rule back in table syntax. Returns the length (snprintf semantics).
+int rule_format(const rule_t *rule, char *out, size_t out_size);
+
+#endif // RULE_ENGINE_H
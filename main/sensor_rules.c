@@ -0,0 +1,186 @@
+#include "sensor_rules.h"
+
+#define RULES_NVS_KEY "table"
+
+static const char *TAG = "RULES";
+
+// Compiled tables; set_table compiles into the spare one and swaps
+static rule_engine_t engines[2];
+static rule_engine_t *engine = &engines[0];
+static SemaphoreHandle_t engine_mutex = NULL;
+static StaticSemaphore_t engine_mutex_buffer;
+static esp_timer_handle_t tick_timer = NULL;
+static uint32_t buzzer_rules = 0; // Firing rules with the buzzer action
+
+static uint32_t now_ms(void) {
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+// Run the actions of a rule that started or stopped firing. ctx is NULL, or
+// the reason a rule is released without a value (table replaced).
+static void on_rule_change(size_t index, const rule_t *rule, bool active,
+                           float value, void *ctx) {
+    const char *reason = ctx;
+    char text[64];
+
+    rule_format(rule, text, sizeof(text));
+    if (active) {
+        ESP_LOGW(TAG, "Rule %u fired: %s (%.1f)", (unsigned)index, text, value);
+    } else if (reason != NULL) {
+        ESP_LOGI(TAG, "Rule %u cleared: %s (%s)", (unsigned)index, text, reason);
+    } else {
+        ESP_LOGI(TAG, "Rule %u cleared: %s (%.1f)", (unsigned)index, text, value);
+    }
+
+    if (rule->actions & RULE_ACTION_BUZZER) {
+        buzzer_rules = active ? buzzer_rules + 1 : buzzer_rules - 1;
+        alarm_monitor_set_rule_alert(buzzer_rules > 0);
+    }
+    if (rule->actions & RULE_ACTION_LED1) {
+        actuator_set(0, active);
+    }
+    if (rule->actions & RULE_ACTION_LED2) {
+        actuator_set(1, active);
+    }
+    if (rule->actions & RULE_ACTION_MQTT) {
+        char payload[128];
+        if (reason != NULL) {
+            snprintf(payload, sizeof(payload), "{\"rule\":%u,\"active\":0,\"reason\":\"%s\",\"text\":\"%s\"}",
+                     (unsigned)index, reason, text);
+        } else {
+            snprintf(payload, sizeof(payload), "{\"rule\":%u,\"active\":%d,\"value\":%.1f,\"text\":\"%s\"}",
+                     (unsigned)index, active, value, text);
+        }
+        publish_scheduler_submit(FEED_ALERTS, payload, 0, 1, 0, PUBLISH_PRIO_ALARM);
+    }
+}
+
+// Sample listener: one pass over the flat rule array
+static void on_sample(const sensor_sample_t *sample) {
+    rule_sample_t input = {
+        .time_ms = (uint32_t)(sample->timestamp_us / 1000),
+        .value = { sample->temperature, sample->humidity },
+        .valid = sample->valid
+    };
+
+    xSemaphoreTake(engine_mutex, portMAX_DELAY);
+    rule_engine_eval(engine, &input, on_rule_change, NULL);
+    xSemaphoreGive(engine_mutex);
+}
+
+// Runs in the esp_timer task: skip this tick rather than wait for a table
+// being compiled
+static void tick_timer_callback(void *arg) {
+    if (xSemaphoreTake(engine_mutex, 0) != pdTRUE) {
+        return;
+    }
+    rule_engine_tick(engine, now_ms(), on_rule_change, NULL);
+    xSemaphoreGive(engine_mutex);
+}
+
+// Rule table upload on FEED_RULES
+static void process_rules_message(const char *topic, size_t topic_len,
+                                  const char *data, size_t data_len, void *ctx) {
+    if (sensor_rules_set_table(data, data_len) != ESP_OK) {
+        ESP_LOGW(TAG, "Rejected rule table: %.*s", (int)data_len, data);
+    }
+}
+
+// Compile into the spare engine and make it current. Caller holds the mutex.
+static int install_table(const char *table, size_t len) {
+    rule_engine_t *spare = (engine == &engines[0]) ? &engines[1] : &engines[0];
+    int count = rule_engine_compile(spare, table, len);
+
+    if (count < 0) {
+        ESP_LOGW(TAG, "Rule table error at offset %d", -1 - count);
+        return count;
+    }
+
+    // Firing rules of the old table release their outputs
+    for (size_t i = 0; i < engine->count; i++) {
+        if (rule_engine_is_active(engine, i)) {
+            on_rule_change(i, &engine->rules[i], false, 0.0f, "table replaced");
+        }
+    }
+    engine = spare;
+    ESP_LOGI(TAG, "Loaded %d rules", count);
+    return count;
+}
+
+// Stored table, or the default if none is stored
+static void load_table(void) {
+    static char table[RULES_TABLE_MAX];
+    size_t size = sizeof(table);
+    nvs_handle_t handle;
+    bool loaded = false;
+
+    if (nvs_open(RULES_NVS_NAMESPACE, NVS_READONLY, &handle) == ESP_OK) {
+        loaded = (nvs_get_str(handle, RULES_NVS_KEY, table, &size) == ESP_OK &&
+                  install_table(table, strlen(table)) >= 0);
+        nvs_close(handle);
+    }
+    if (!loaded) {
+        install_table(RULES_DEFAULT_TABLE, strlen(RULES_DEFAULT_TABLE));
+    }
+}
+
+void sensor_rules_init(void) {
+    engine_mutex = xSemaphoreCreateMutexStatic(&engine_mutex_buffer);
+    load_table();
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = tick_timer_callback,
+        .name = "rules_tick"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&timer_args, &tick_timer));
+    ESP_ERROR_CHECK(esp_timer_start_periodic(tick_timer, RULES_TICK_MS * 1000));
+
+    dht11_register_listener(on_sample);
+    topic_router_register(FEED_RULES, process_rules_message, NULL);
+}
+
+esp_err_t sensor_rules_set_table(const char *table, size_t len) {
+    char text[RULES_TABLE_MAX];
+    nvs_handle_t handle;
+
+    if (len >= sizeof(text)) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    memcpy(text, table, len);
+    text[len] = '\0';
+
+    xSemaphoreTake(engine_mutex, portMAX_DELAY);
+    int count = (len == 0) ? install_table(RULES_DEFAULT_TABLE, strlen(RULES_DEFAULT_TABLE))
+                           : install_table(text, len);
+    xSemaphoreGive(engine_mutex);
+    if (count < 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = nvs_open(RULES_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = (len == 0) ? nvs_erase_key(handle, RULES_NVS_KEY) : nvs_set_str(handle, RULES_NVS_KEY, text);
+    if (err == ESP_ERR_NVS_NOT_FOUND) {
+        err = ESP_OK;
+    }
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+bool sensor_rules_get(size_t index, char *text, size_t text_size, bool *active) {
+    bool found = false;
+
+    xSemaphoreTake(engine_mutex, portMAX_DELAY);
+    if (index < engine->count) {
+        rule_format(&engine->rules[index], text, text_size);
+        *active = rule_engine_is_active(engine, index);
+        found = true;
+    }
+    xSemaphoreGive(engine_mutex);
+    return found;
+}
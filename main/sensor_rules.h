@@ -0,0 +1,42 @@
+// sensor_rules.h
+#ifndef SENSOR_RULES_H
+#define SENSOR_RULES_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "static_mem.h"
+#include "nvs.h"
+#include "global_data.h"
+#include "dht11_task.h"
+#include "rule_engine.h"
+#include "alarm_monitor.h"
+#include "publish_scheduler.h"
+#include "topic_router.h"
+#include "actuator.h"
+
+#define RULES_NVS_NAMESPACE "rules"
+#define RULES_TABLE_MAX 512
+#define RULES_TICK_MS 1000 // Evaluation of silent rules between samples
+
+// Used until a table is stored in NVS or received on FEED_RULES
+#define RULES_DEFAULT_TABLE "hum > 85 for 300 -> mqtt; temp rise 2 for 60 -> mqtt; silent 30 -> mqtt"
+
+// Load and compile the stored table, attach to the sensor samples and route
+// FEED_RULES (call before the DHT11 and MQTT tasks start)
+void sensor_rules_init(void);
+
+// Compile and store a new table (an empty table restores the default).
+// Returns ESP_ERR_INVALID_ARG if it does not compile; the old rules stay.
+esp_err_t sensor_rules_set_table(const char *table, size_t len);
+
+// Rule text and firing state, false if index is out of range
+bool sensor_rules_get(size_t index, char *text, size_t text_size, bool *active);
+
+#endif // SENSOR_RULES_H
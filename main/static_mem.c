@@ -0,0 +1,65 @@
+#include "static_mem.h"
+
+static const char *TAG = "STATIC_MEM";
+
+static volatile bool sealed = false;
+
+#if CONFIG_APP_STATIC_MEMORY
+// Code of this component (linker.lf)
+extern const char _app_text_start[];
+extern const char _app_text_end[];
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t count, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+// Runs inside the allocator: ROM printf only, esp_log may allocate itself
+static void check_caller(const void *caller, const char *what, size_t size) {
+    if (sealed && (const char *)caller >= _app_text_start && (const char *)caller < _app_text_end) {
+        esp_rom_printf("E %s: %s(%u) after startup from %p\n", TAG, what, (unsigned)size, caller);
+        abort();
+    }
+}
+
+void *__wrap_malloc(size_t size) {
+    check_caller(__builtin_return_address(0), "malloc", size);
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    check_caller(__builtin_return_address(0), "calloc", count * size);
+    return __real_calloc(count, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    check_caller(__builtin_return_address(0), "realloc", size);
+    return __real_realloc(ptr, size);
+}
+#endif
+
+void static_mem_seal(void) {
+    if (sealed) {
+        return;
+    }
+    sealed = true;
+    ESP_LOGI(TAG, "Startup complete: internal heap %u free, %u largest block, %u minimum",
+             (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL),
+             (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL));
+}
+
+void static_mem_check(const char *what) {
+    if (!sealed) {
+        return;
+    }
+    ESP_LOGE(TAG, "Heap allocation after startup: %s", what);
+#if CONFIG_APP_STATIC_MEMORY
+    abort();
+#endif
+}
+
+esp_err_t static_mem_timer_create(const esp_timer_create_args_t *args,
+                                  esp_timer_handle_t *out) {
+    static_mem_check(args->name);
+    return esp_timer_create(args, out);
+}
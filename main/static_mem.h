@@ -0,0 +1,35 @@
+// static_mem.h
+#ifndef STATIC_MEM_H
+#define STATIC_MEM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "sdkconfig.h"
+
+// Memory plan: application objects are reserved at link time (static
+// stacks, pools, mutexes) or created once during startup. After
+// static_mem_seal() any further application allocation is an error; with
+// CONFIG_APP_STATIC_MEMORY it aborts so the offending path is found in
+// testing rather than after weeks of fragmentation. That build also wraps
+// malloc/calloc/realloc (main/CMakeLists.txt) and aborts when code of this
+// component calls them after the seal; the libraries (WiFi, LwIP, mbedTLS,
+// esp-mqtt) keep their own heap use.
+
+// Mark the end of startup and log the heap left for the libraries
+void static_mem_seal(void);
+
+// Call before any application heap allocation (task, timer, buffer)
+void static_mem_check(const char *what);
+
+// esp_timer_create() for startup code (esp_timer has no static variant)
+esp_err_t static_mem_timer_create(const esp_timer_create_args_t *args,
+                                  esp_timer_handle_t *out);
+
+#endif // STATIC_MEM_H
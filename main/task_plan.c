@@ -0,0 +1,107 @@
+#include "task_plan.h"
+
+static const char *TAG = "TASK_PLAN";
+
+// Single-core targets and the unpinned baseline let the scheduler pick
+#if CONFIG_FREERTOS_UNICORE
+#define PLAN_CORE(core) 0
+#elif CONFIG_APP_TASK_PINNING
+#define PLAN_CORE(core) (core)
+#else
+#define PLAN_CORE(core) tskNO_AFFINITY
+#endif
+
+// Static memory plan: stacks and TCBs reserved at link time
+#if CONFIG_APP_STATIC_MEMORY
+static struct {
+    StackType_t wifi[CONFIG_APP_TASK_WIFI_STACK];
+    StackType_t dht11[CONFIG_APP_TASK_DHT11_STACK];
+    StackType_t mqtt[CONFIG_APP_TASK_MQTT_STACK];
+    StackType_t publish[CONFIG_APP_TASK_PUBLISH_STACK];
+    StackType_t oled[CONFIG_APP_TASK_OLED_STACK];
+} stacks;
+static StaticTask_t tcbs[TASK_PLAN_COUNT];
+
+_Static_assert(sizeof(stacks) <= CONFIG_APP_STATIC_STACK_BUDGET,
+               "Task stacks exceed CONFIG_APP_STATIC_STACK_BUDGET");
+#define PLAN_STACK(task) stacks.task
+#else
+#define PLAN_STACK(task) NULL
+#endif
+
+static const task_plan_entry_t plan[TASK_PLAN_COUNT] = {
+    // Network first: MQTT waits on it
+    [TASK_PLAN_WIFI] = { "wifi_task", wifi_task, CONFIG_APP_TASK_WIFI_STACK,
+                         CONFIG_APP_TASK_WIFI_PRIORITY, PLAN_CORE(CONFIG_APP_TASK_WIFI_CORE),
+                         PLAN_STACK(wifi) },
+    [TASK_PLAN_DHT11] = { "dht11_sensor", dht11_task, CONFIG_APP_TASK_DHT11_STACK,
+                          CONFIG_APP_TASK_DHT11_PRIORITY, PLAN_CORE(CONFIG_APP_TASK_DHT11_CORE),
+                          PLAN_STACK(dht11) },
+    [TASK_PLAN_MQTT] = { "mqtt_client", mqtt_task_pubsub, CONFIG_APP_TASK_MQTT_STACK,
+                         CONFIG_APP_TASK_MQTT_PRIORITY, PLAN_CORE(CONFIG_APP_TASK_MQTT_CORE),
+                         PLAN_STACK(mqtt) },
+    [TASK_PLAN_PUBLISH] = { "mqtt_publisher", publish_scheduler_task, CONFIG_APP_TASK_PUBLISH_STACK,
+                            CONFIG_APP_TASK_PUBLISH_PRIORITY, PLAN_CORE(CONFIG_APP_TASK_PUBLISH_CORE),
+                            PLAN_STACK(publish) },
+    [TASK_PLAN_OLED] = { "oled_display", oled_task, CONFIG_APP_TASK_OLED_STACK,
+                         CONFIG_APP_TASK_OLED_PRIORITY, PLAN_CORE(CONFIG_APP_TASK_OLED_CORE),
+                         PLAN_STACK(oled) },
+};
+
+// handles[] is cleared under the mutex before a task exits, so a stack
+// query never reaches a freed control block
+static TaskHandle_t handles[TASK_PLAN_COUNT];
+static SemaphoreHandle_t handles_mutex = NULL;
+static StaticSemaphore_t handles_mutex_buffer;
+
+void task_plan_start(void) {
+    handles_mutex = xSemaphoreCreateMutexStatic(&handles_mutex_buffer);
+    for (int i = 0; i < TASK_PLAN_COUNT; i++) {
+        const task_plan_entry_t *task = &plan[i];
+#if CONFIG_APP_STATIC_MEMORY
+        handles[i] = xTaskCreateStaticPinnedToCore(task->func, task->name, task->stack_size, NULL,
+                                                   task->priority, task->stack, &tcbs[i], task->core);
+        BaseType_t result = (handles[i] != NULL) ? pdPASS : pdFAIL;
+#else
+        static_mem_check(task->name);
+        BaseType_t result = xTaskCreatePinnedToCore(task->func, task->name, task->stack_size,
+                                                    NULL, task->priority, &handles[i], task->core);
+#endif
+
+        if (result == pdPASS) {
+            ESP_LOGI(TAG, "Created task: %s (core %d, priority %u, stack %u)", task->name,
+                     task->core == tskNO_AFFINITY ? -1 : (int)task->core,
+                     (unsigned)task->priority, (unsigned)task->stack_size);
+        } else {
+            handles[i] = NULL;
+            ESP_LOGE(TAG, "Failed to create task: %s", task->name);
+        }
+    }
+}
+
+const task_plan_entry_t *task_plan_get(task_plan_id_t id) {
+    return &plan[id];
+}
+
+TaskHandle_t task_plan_handle(task_plan_id_t id) {
+    return handles[id];
+}
+
+// High-water marks are in bytes on ESP-IDF (StackType_t is one byte)
+int32_t task_plan_stack_free(task_plan_id_t id) {
+    int32_t free_bytes = -1;
+
+    xSemaphoreTake(handles_mutex, portMAX_DELAY);
+    if (handles[id] != NULL) {
+        free_bytes = (int32_t)uxTaskGetStackHighWaterMark(handles[id]);
+    }
+    xSemaphoreGive(handles_mutex);
+    return free_bytes;
+}
+
+void task_plan_exit(task_plan_id_t id) {
+    xSemaphoreTake(handles_mutex, portMAX_DELAY);
+    handles[id] = NULL;
+    xSemaphoreGive(handles_mutex);
+    vTaskDelete(NULL);
+}
@@ -0,0 +1,55 @@
+// task_plan.h
+#ifndef TASK_PLAN_H
+#define TASK_PLAN_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "static_mem.h"
+#include "wifi_config.h"
+#include "dht11_task.h"
+#include "oled_task.h"
+#include "mqtt_task.h"
+#include "publish_scheduler.h"
+
+// Application tasks, in creation (dependency) order
+typedef enum {
+    TASK_PLAN_WIFI = 0,
+    TASK_PLAN_DHT11,
+    TASK_PLAN_MQTT,
+    TASK_PLAN_PUBLISH,
+    TASK_PLAN_OLED,
+    TASK_PLAN_COUNT
+} task_plan_id_t;
+
+// Placement of one task (menuconfig "Task placement", main/Kconfig.projbuild)
+typedef struct {
+    const char *name;
+    TaskFunction_t func;
+    uint32_t stack_size;
+    UBaseType_t priority;
+    BaseType_t core; // tskNO_AFFINITY when pinning is disabled
+    StackType_t *stack; // Static stack (CONFIG_APP_STATIC_MEMORY), else NULL
+} task_plan_entry_t;
+
+// Create every task of the plan, pinned to its core (static stacks with
+// CONFIG_APP_STATIC_MEMORY)
+void task_plan_start(void);
+
+const task_plan_entry_t *task_plan_get(task_plan_id_t id);
+
+// Handle of a created task (NULL if creation failed, not started yet or
+// exited). Only for presence checks: the task may exit at any time.
+TaskHandle_t task_plan_handle(task_plan_id_t id);
+
+// Least free stack in bytes since the task started, -1 if it is not running
+int32_t task_plan_stack_free(task_plan_id_t id);
+
+// Delete the calling plan task (use instead of vTaskDelete(NULL))
+void task_plan_exit(task_plan_id_t id);
+
+#endif // TASK_PLAN_H
@@ -0,0 +1,58 @@
+#include "time_sync.h"
+
+static const char *TAG = "TIME_SYNC";
+
+// Unix time minus esp_timer time, in microseconds (0 = not synced)
+static int64_t unix_offset_us = 0;
+static portMUX_TYPE offset_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Read the offset atomically (64-bit access is not atomic on this target)
+static int64_t get_offset(void) {
+    portENTER_CRITICAL(&offset_lock);
+    int64_t offset = unix_offset_us;
+    portEXIT_CRITICAL(&offset_lock);
+    return offset;
+}
+
+// SNTP sync notification
+static void on_time_synced(struct timeval *tv) {
+    int64_t unix_us = (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+    int64_t offset = unix_us - esp_timer_get_time();
+
+    portENTER_CRITICAL(&offset_lock);
+    int64_t previous = unix_offset_us;
+    unix_offset_us = offset;
+    portEXIT_CRITICAL(&offset_lock);
+
+    if (previous != 0) {
+        ESP_LOGI(TAG, "Time resynced, drift correction %lld ms",
+                 (long long)((offset - previous) / 1000));
+    } else {
+        ESP_LOGI(TAG, "Time synced with %s", SNTP_SERVER);
+    }
+}
+
+void time_sync_start(void) {
+    if (sntp_enabled()) {
+        return;
+    }
+
+    sntp_setoperatingmode(SNTP_OPMODE_POLL);
+    sntp_setservername(0, SNTP_SERVER);
+    sntp_set_time_sync_notification_cb(on_time_synced);
+    sntp_init();
+    ESP_LOGI(TAG, "SNTP started (server: %s)", SNTP_SERVER);
+}
+
+bool time_sync_is_synced(void) {
+    return get_offset() != 0;
+}
+
+uint64_t time_sync_to_unix_ms(int64_t monotonic_us) {
+    int64_t offset = get_offset();
+
+    if (offset == 0) {
+        return 0;
+    }
+    return (uint64_t)((monotonic_us + offset) / 1000);
+}
@@ -0,0 +1,23 @@
+// time_sync.h
+#ifndef TIME_SYNC_H
+#define TIME_SYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/time.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_sntp.h"
+#include "esp_timer.h"
+#include "global_data.h"
+
+// Start SNTP against SNTP_SERVER (safe to call on every reconnect)
+void time_sync_start(void);
+
+bool time_sync_is_synced(void);
+
+// Convert a monotonic esp_timer timestamp to Unix time in milliseconds using
+// the offset measured at the last SNTP sync. Returns 0 before the first sync.
+uint64_t time_sync_to_unix_ms(int64_t monotonic_us);
+
+#endif // TIME_SYNC_H
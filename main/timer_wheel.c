@@ -0,0 +1,117 @@
+#include "timer_wheel.h"
+
+#define TW_SLOT_MASK (TW_SLOTS - 1)
+
+static void list_init(tw_node_t *head) {
+    head->next = head;
+    head->prev = head;
+}
+
+static void list_append(tw_node_t *head, tw_node_t *node) {
+    node->prev = head->prev;
+    node->next = head;
+    head->prev->next = node;
+    head->prev = node;
+}
+
+static void list_remove(tw_node_t *node) {
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+// Slot for node->expires as seen from tw->now (expires may equal now)
+static void place(timer_wheel_t *tw, tw_node_t *node) {
+    uint32_t delta = node->expires - tw->now;
+    int level = 0;
+
+    while (level < TW_LEVELS - 1 && delta >= (1u << ((level + 1) * TW_SLOT_BITS))) {
+        level++;
+    }
+    list_append(&tw->slots[level][(node->expires >> (level * TW_SLOT_BITS)) & TW_SLOT_MASK], node);
+}
+
+void tw_init(timer_wheel_t *tw, uint32_t now) {
+    for (int level = 0; level < TW_LEVELS; level++) {
+        for (uint32_t slot = 0; slot < TW_SLOTS; slot++) {
+            list_init(&tw->slots[level][slot]);
+        }
+    }
+    tw->now = now;
+    tw->count = 0;
+}
+
+void tw_set_now(timer_wheel_t *tw, uint32_t now) {
+    if (tw->count == 0) {
+        tw->now = now;
+    }
+}
+
+void tw_insert(timer_wheel_t *tw, tw_node_t *node, uint32_t delay) {
+    if (delay == 0) {
+        delay = 1; // The slot of the current tick has already run
+    } else if (delay > TW_MAX_DELAY) {
+        delay = TW_MAX_DELAY;
+    }
+    if (tw_pending(node)) {
+        tw_cancel(tw, node);
+    }
+
+    node->expires = tw->now + delay;
+    place(tw, node);
+    tw->count++;
+}
+
+void tw_cancel(timer_wheel_t *tw, tw_node_t *node) {
+    if (tw_pending(node)) {
+        list_remove(node);
+        tw->count--;
+    }
+}
+
+bool tw_pending(const tw_node_t *node) {
+    return node->next != NULL;
+}
+
+// Re-place every node of a higher-level slot relative to the current tick
+static void cascade(timer_wheel_t *tw, int level) {
+    tw_node_t *head = &tw->slots[level][(tw->now >> (level * TW_SLOT_BITS)) & TW_SLOT_MASK];
+    tw_node_t pending;
+
+    // Detach the list first: nodes may land back in this same slot
+    if (head->next == head) {
+        return;
+    }
+    pending.next = head->next;
+    pending.prev = head->prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    list_init(head);
+
+    while (pending.next != &pending) {
+        tw_node_t *node = pending.next;
+        list_remove(node);
+        place(tw, node);
+    }
+}
+
+void tw_tick(timer_wheel_t *tw, tw_expire_cb_t cb, void *ctx) {
+    tw->now++;
+
+    // Each level cascades when all the levels below it wrap
+    for (int level = 1; level < TW_LEVELS; level++) {
+        if ((tw->now & ((1u << (level * TW_SLOT_BITS)) - 1)) != 0) {
+            break;
+        }
+        cascade(tw, level);
+    }
+
+    tw_node_t *head = &tw->slots[0][tw->now & TW_SLOT_MASK];
+    while (head->next != head) {
+        tw_node_t *node = head->next;
+        list_remove(node);
+        tw->count--;
+        cb(node, ctx);
+    }
+}
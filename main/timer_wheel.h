@@ -0,0 +1,49 @@
+// timer_wheel.h
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hierarchical timer wheel: 4 levels of 64 slots. Level 0 holds timers due
+// within 64 ticks, each higher level 64x further out (up to 2^24 ticks).
+// Insert and cancel are O(1); a tick expires one level-0 slot and, every
+// 64 ticks, redistributes one slot of the level above.
+#define TW_LEVELS 4
+#define TW_SLOT_BITS 6
+#define TW_SLOTS (1u << TW_SLOT_BITS)
+#define TW_MAX_DELAY ((1u << (TW_LEVELS * TW_SLOT_BITS)) - 1)
+
+// Embed as a member of the timed object (intrusive list node)
+typedef struct tw_node {
+    struct tw_node *next;
+    struct tw_node *prev;
+    uint32_t expires; // Tick the timer is due
+} tw_node_t;
+
+typedef struct {
+    tw_node_t slots[TW_LEVELS][TW_SLOTS]; // List heads
+    uint32_t now;
+    size_t count;
+} timer_wheel_t;
+
+typedef void (*tw_expire_cb_t)(tw_node_t *node, void *ctx);
+
+void tw_init(timer_wheel_t *tw, uint32_t now);
+
+// Move the clock of an empty wheel (e.g. after sleeping while idle)
+void tw_set_now(timer_wheel_t *tw, uint32_t now);
+
+// Schedule node delay ticks from now (0 runs on the next tick; longer
+// delays are clamped to TW_MAX_DELAY)
+void tw_insert(timer_wheel_t *tw, tw_node_t *node, uint32_t delay);
+
+void tw_cancel(timer_wheel_t *tw, tw_node_t *node);
+bool tw_pending(const tw_node_t *node);
+
+// Advance the clock by one tick, calling cb for each expired node (already
+// removed, so cb may re-insert it)
+void tw_tick(timer_wheel_t *tw, tw_expire_cb_t cb, void *ctx);
+
+#endif // TIMER_WHEEL_H
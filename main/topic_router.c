@@ -0,0 +1,148 @@
+#include "topic_router.h"
+#include <string.h>
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+typedef struct {
+    const char *filter;
+    size_t filter_len;
+    uint32_t hash;
+    bool wildcard;
+    topic_handler_t handler;
+    void *ctx;
+} topic_route_t;
+
+static topic_route_t routes[TOPIC_ROUTER_MAX_ROUTES];
+static size_t route_count = 0;
+
+// Open-addressing table of exact routes (route index + 1, 0 = empty slot)
+static uint8_t exact_table[TOPIC_ROUTER_TABLE_SIZE];
+
+// Wildcard routes are few, kept aside and only tried on an exact miss
+static uint8_t wildcard_routes[TOPIC_ROUTER_MAX_ROUTES];
+static size_t wildcard_count = 0;
+
+// FNV-1a hash over a length-delimited topic
+static uint32_t topic_hash(const char *topic, size_t len) {
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= (uint8_t)topic[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Check whether a filter contains MQTT wildcard characters
+static bool is_wildcard_filter(const char *filter) {
+    return strchr(filter, '+') != NULL || strchr(filter, '#') != NULL;
+}
+
+// Match a topic against an MQTT filter ('+' = one level, '#' = remaining levels)
+static bool wildcard_match(const char *filter, const char *topic, size_t topic_len) {
+    size_t t = 0;
+
+    while (*filter) {
+        if (*filter == '#') {
+            return true;
+        }
+        if (*filter == '+') {
+            while (t < topic_len && topic[t] != '/') {
+                t++;
+            }
+            filter++;
+            continue;
+        }
+        if (t >= topic_len || *filter != topic[t]) {
+            // "a/#" also matches the parent level "a"
+            return t == topic_len && filter[0] == '/' && filter[1] == '#' && filter[2] == '\0';
+        }
+        filter++;
+        t++;
+    }
+    return t == topic_len;
+}
+
+// Insert route into the exact-match table
+static bool insert_exact(uint8_t route_index) {
+    uint32_t mask = TOPIC_ROUTER_TABLE_SIZE - 1;
+    uint32_t slot = routes[route_index].hash & mask;
+
+    for (size_t probe = 0; probe < TOPIC_ROUTER_TABLE_SIZE; probe++) {
+        if (exact_table[slot] == 0) {
+            exact_table[slot] = route_index + 1;
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return false;
+}
+
+// Find an exact route for the topic, or NULL
+static const topic_route_t *lookup_exact(const char *topic, size_t topic_len) {
+    uint32_t hash = topic_hash(topic, topic_len);
+    uint32_t mask = TOPIC_ROUTER_TABLE_SIZE - 1;
+    uint32_t slot = hash & mask;
+
+    while (exact_table[slot] != 0) {
+        const topic_route_t *route = &routes[exact_table[slot] - 1];
+        if (route->hash == hash && route->filter_len == topic_len &&
+            memcmp(route->filter, topic, topic_len) == 0) {
+            return route;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+bool topic_router_register(const char *filter, topic_handler_t handler, void *ctx) {
+    if (filter == NULL || handler == NULL || route_count >= TOPIC_ROUTER_MAX_ROUTES) {
+        return false;
+    }
+
+    topic_route_t *route = &routes[route_count];
+    route->filter = filter;
+    route->filter_len = strlen(filter);
+    route->hash = topic_hash(filter, route->filter_len);
+    route->wildcard = is_wildcard_filter(filter);
+    route->handler = handler;
+    route->ctx = ctx;
+
+    if (route->wildcard) {
+        wildcard_routes[wildcard_count++] = (uint8_t)route_count;
+    } else if (lookup_exact(filter, route->filter_len) != NULL ||
+               !insert_exact((uint8_t)route_count)) {
+        return false;
+    }
+
+    route_count++;
+    return true;
+}
+
+bool topic_router_dispatch(const char *topic, size_t topic_len,
+                           const char *data, size_t data_len) {
+    const topic_route_t *route = lookup_exact(topic, topic_len);
+
+    if (route == NULL) {
+        for (size_t i = 0; i < wildcard_count; i++) {
+            const topic_route_t *candidate = &routes[wildcard_routes[i]];
+            if (wildcard_match(candidate->filter, topic, topic_len)) {
+                route = candidate;
+                break;
+            }
+        }
+    }
+
+    if (route == NULL) {
+        return false;
+    }
+
+    route->handler(topic, topic_len, data, data_len, route->ctx);
+    return true;
+}
+
+void topic_router_for_each(topic_filter_cb_t cb, void *arg) {
+    for (size_t i = 0; i < route_count; i++) {
+        cb(routes[i].filter, arg);
+    }
+}
@@ -0,0 +1,31 @@
+// topic_router.h
+#ifndef TOPIC_ROUTER_H
+#define TOPIC_ROUTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Router capacity
+#define TOPIC_ROUTER_MAX_ROUTES 32
+#define TOPIC_ROUTER_TABLE_SIZE 64 // Power of two, at least 2x MAX_ROUTES
+
+// Handler invoked for a message whose topic matches a registered filter
+typedef void (*topic_handler_t)(const char *topic, size_t topic_len,
+                                const char *data, size_t data_len, void *ctx);
+
+// Callback used to enumerate registered filters (e.g. for subscribing)
+typedef void (*topic_filter_cb_t)(const char *filter, void *arg);
+
+// Register a handler for an exact topic or an MQTT wildcard filter (+, #).
+// Must be called before the MQTT client starts delivering messages.
+bool topic_router_register(const char *filter, topic_handler_t handler, void *ctx);
+
+// Dispatch a message to its handler. Returns false if no route matched.
+bool topic_router_dispatch(const char *topic, size_t topic_len,
+                           const char *data, size_t data_len);
+
+// Enumerate all registered filters in registration order
+void topic_router_for_each(topic_filter_cb_t cb, void *arg);
+
+#endif // TOPIC_ROUTER_H
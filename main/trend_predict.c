@@ -0,0 +1,120 @@
+#include "trend_predict.h"
+#include <string.h>
+
+static void add_sums(trend_t *trend, float t, float y, double sign) {
+    trend->sum_t += sign * t;
+    trend->sum_y += sign * y;
+    trend->sum_tt += sign * (double)t * t;
+    trend->sum_ty += sign * (double)t * y;
+}
+
+// Move the time origin to the oldest sample and rebuild the sums (O(window),
+// once per TREND_REBASE_MS)
+static void rebase(trend_t *trend, uint32_t time_ms) {
+    float shift = trend->count ? trend->t[trend->head] : (float)(time_ms - trend->origin_ms) / 1000.0f;
+
+    trend->origin_ms += (uint32_t)(shift * 1000.0f);
+    trend->sum_t = trend->sum_y = trend->sum_tt = trend->sum_ty = 0.0;
+    for (uint16_t i = 0; i < trend->count; i++) {
+        uint16_t idx = (trend->head + i) % trend->capacity;
+        trend->t[idx] -= shift;
+        add_sums(trend, trend->t[idx], trend->y[idx], 1.0);
+    }
+}
+
+void trend_init(trend_t *trend, uint16_t window) {
+    memset(trend, 0, sizeof(*trend));
+    if (window < 2) {
+        window = 2;
+    }
+    trend->capacity = window > TREND_WINDOW_MAX ? TREND_WINDOW_MAX : window;
+}
+
+void trend_add(trend_t *trend, uint32_t time_ms, float value) {
+    if (trend->count == 0) {
+        trend->origin_ms = time_ms;
+    } else if (time_ms - trend->origin_ms >= TREND_REBASE_MS) {
+        rebase(trend, time_ms);
+    }
+
+    float t = (float)(time_ms - trend->origin_ms) / 1000.0f;
+    uint16_t tail = (trend->head + trend->count) % trend->capacity;
+
+    if (trend->count == trend->capacity) {
+        add_sums(trend, trend->t[trend->head], trend->y[trend->head], -1.0);
+        trend->head = (trend->head + 1) % trend->capacity;
+    } else {
+        trend->count++;
+    }
+    trend->t[tail] = t;
+    trend->y[tail] = value;
+    add_sums(trend, t, value, 1.0);
+}
+
+bool trend_fit(const trend_t *trend, uint32_t now_ms, float *slope, float *value) {
+    double n = trend->count;
+
+    if (trend->count < TREND_MIN_SAMPLES) {
+        return false;
+    }
+    double denom = n * trend->sum_tt - trend->sum_t * trend->sum_t;
+    if (denom <= 1e-9) {
+        return false;
+    }
+
+    double b = (n * trend->sum_ty - trend->sum_t * trend->sum_y) / denom;
+    double a = (trend->sum_y - b * trend->sum_t) / n;
+    double t_now = (double)(now_ms - trend->origin_ms) / 1000.0;
+    *slope = (float)b;
+    *value = (float)(a + b * t_now);
+    return true;
+}
+
+bool trend_time_to(const trend_t *trend, uint32_t now_ms, float threshold, float *seconds) {
+    float slope, value;
+
+    if (!trend_fit(trend, now_ms, &slope, &value)) {
+        return false;
+    }
+    if (value >= threshold) {
+        *seconds = 0.0f;
+        return true;
+    }
+    if (slope <= 0.0f) {
+        return false;
+    }
+    *seconds = (threshold - value) / slope;
+    return true;
+}
+
+void prealarm_init(prealarm_t *p, uint16_t window) {
+    trend_init(&p->trend, window);
+    p->active = false;
+}
+
+bool prealarm_update(prealarm_t *p, uint32_t time_ms, float value, float threshold,
+                     float horizon_s, float *time_to_s) {
+    float seconds = -1.0f;
+    bool approaching;
+    bool active;
+
+    trend_add(&p->trend, time_ms, value);
+    approaching = trend_time_to(&p->trend, time_ms, threshold, &seconds);
+
+    if (horizon_s <= 0.0f) {
+        active = false;
+    } else if (p->active) {
+        active = approaching && seconds <= horizon_s * TREND_CLEAR_FACTOR;
+    } else {
+        active = approaching && seconds <= horizon_s;
+    }
+    if (time_to_s) {
+        *time_to_s = seconds;
+    }
+
+    if (active == p->active) {
+        return false;
+    }
+    p->active = active;
+    return true;
+}
@@ -0,0 +1,56 @@
+// trend_predict.h
+#ifndef TREND_PREDICT_H
+#define TREND_PREDICT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Sliding-window least-squares line over the last samples. Running sums are
+// updated in O(1) per sample; times are kept relative to an origin that is
+// moved forward every TREND_REBASE_MS to keep the sums precise.
+#define TREND_WINDOW_MAX 64
+#define TREND_MIN_SAMPLES 8
+#define TREND_REBASE_MS 3600000
+#define TREND_CLEAR_FACTOR 2.0f // A pre-alarm clears beyond horizon x factor
+
+typedef struct {
+    float t[TREND_WINDOW_MAX]; // Seconds since origin_ms
+    float y[TREND_WINDOW_MAX];
+    uint16_t capacity;
+    uint16_t count;
+    uint16_t head; // Oldest sample
+    uint32_t origin_ms;
+    double sum_t;
+    double sum_y;
+    double sum_tt;
+    double sum_ty;
+} trend_t;
+
+typedef struct {
+    trend_t trend;
+    bool active;
+} prealarm_t;
+
+// window: samples in the fit (clamped to 2..TREND_WINDOW_MAX)
+void trend_init(trend_t *trend, uint16_t window);
+
+void trend_add(trend_t *trend, uint32_t time_ms, float value);
+
+// Fitted slope (units per second) and value at now_ms; false until
+// TREND_MIN_SAMPLES samples spanning a non-zero time are in the window
+bool trend_fit(const trend_t *trend, uint32_t now_ms, float *slope, float *value);
+
+// Seconds until the fitted line reaches threshold (0 if already there);
+// false if the line is not heading towards it
+bool trend_time_to(const trend_t *trend, uint32_t now_ms, float threshold, float *seconds);
+
+void prealarm_init(prealarm_t *p, uint16_t window);
+
+// Add a sample and re-evaluate: active once the projected time to threshold
+// is within horizon_s (never with horizon_s <= 0). Returns true when the
+// active state changed.
+bool prealarm_update(prealarm_t *p, uint32_t time_ms, float value, float threshold,
+                     float horizon_s, float *time_to_s);
+
+#endif // TREND_PREDICT_H
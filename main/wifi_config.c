@@ -1,48 +1,37 @@
 #include "wifi_config.h"
 
 static const char *TAG = "WIFI_CONFIG";
-static char ssid[WIFI_SSID_MAX_LEN] = {0};
-static char password[WIFI_PASS_MAX_LEN] = {0};
-
-// Read user input from UART with timeout
-static void read_uart_input(char *buffer, int max_len, const char* prompt) {
-    printf("%s", prompt);
-    fflush(stdout);
-    
-    int len = 0;
-    while (len < max_len - 1) {
-        int bytes_read = uart_read_bytes(UART_NUM, (uint8_t*)&buffer[len], 1, 
-                                        pdMS_TO_TICKS(30000)); // 30s timeout
-        
-        if (bytes_read > 0) {
-            if (buffer[len] == '\n' || buffer[len] == '\r') {
-                buffer[len] = '\0';
-                printf("\n");
-                break;
-            }
-            printf("%c", buffer[len]); // Echo character
-            len++;
-        } else {
-            ESP_LOGW(TAG, "UART read timeout");
-            break;
-        }
-    }
-    buffer[len] = '\0';
-}
+static wifi_stored_config_t stored;
+static SemaphoreHandle_t store_mutex = NULL;
+static StaticSemaphore_t store_mutex_buffer;
+static esp_netif_ip_info_t last_ip_info;
+static esp_netif_t *sta_netif = NULL;
 
 // WiFi event handler
 static void wifi_event_handler(void* arg, esp_event_base_t event_base,
                               int32_t event_id, void* event_data) {
     switch (event_id) {
         case WIFI_EVENT_STA_START:
-            ESP_LOGI(TAG, "WiFi station started, connecting...");
-            esp_wifi_connect();
+            ESP_LOGI(TAG, "WiFi station started");
+            break;
+            
+        case WIFI_EVENT_STA_CONNECTED:
+            net_state_set(NET_LINK_UP);
+            ip_config_on_associated(((wifi_event_sta_connected_t*) event_data)->bssid);
             break;
             
         case WIFI_EVENT_STA_DISCONNECTED:
-            ESP_LOGW(TAG, "WiFi disconnected, attempting reconnect...");
-            wifi_connected = false;
-            esp_wifi_connect();
+            net_state_clear(NET_LINK_UP | NET_GOT_IP);
+            power_save_on_link(false);
+            wifi_reconnect_on_disconnected((wifi_event_sta_disconnected_t*) event_data);
+            break;
+            
+        case WIFI_EVENT_SCAN_DONE:
+            wifi_reconnect_on_scan_done();
+            break;
+            
+        case WIFI_EVENT_STA_BSS_RSSI_LOW:
+            wifi_reconnect_on_rssi_low();
             break;
             
         default:
@@ -55,73 +44,96 @@ static void ip_event_handler(void* arg, esp_event_base_t event_base,
                             int32_t event_id, void* event_data) {
     if (event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
-        ESP_LOGI(TAG, "WiFi connected successfully! IP: " IPSTR, 
-                 IP2STR(&event->ip_info.ip));
-        wifi_connected = true;
+        ESP_LOGI(TAG, "WiFi connected successfully! IP: " IPSTR ", %lld ms after boot",
+                 IP2STR(&event->ip_info.ip), esp_timer_get_time() / 1000);
+        last_ip_info = event->ip_info;
+        net_state_set(NET_GOT_IP);
+        ip_config_on_got_ip();
+        power_save_on_link(true);
+        wifi_reconnect_on_got_ip();
+        time_sync_start();
+    } else if (event_id == IP_EVENT_STA_LOST_IP) {
+        ESP_LOGW(TAG, "WiFi IP address lost");
+        net_state_clear(NET_GOT_IP);
     }
 }
 
-// Initialize UART for user input
-static void init_uart(void) {
-    uart_config_t uart_config = {
-        .baud_rate = 115200,
-        .data_bits = UART_DATA_8_BITS,
-        .parity = UART_PARITY_DISABLE,
-        .stop_bits = UART_STOP_BITS_1,
-        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE
-    };
-    
-    ESP_ERROR_CHECK(uart_param_config(UART_NUM, &uart_config));
-    ESP_ERROR_CHECK(uart_driver_install(UART_NUM, 1024, 0, 0, NULL, 0));
+// Connect to the stored network: straight to the cached AP when known,
+// otherwise the highest priority network on any AP (caller holds store_mutex)
+static void connect_stored(void) {
+    if (stored.last >= 0) {
+        wifi_reconnect_connect(&stored.networks[stored.last],
+                               stored.has_ap ? stored.bssid : NULL, stored.channel);
+        return;
+    }
+    
+    int best = -1;
+    for (int i = 0; i < WIFI_KNOWN_NETWORKS_MAX; i++) {
+        if (stored.networks[i].ssid[0] != '\0' &&
+            (best < 0 || stored.networks[i].priority > stored.networks[best].priority)) {
+            best = i;
+        }
+    }
+    if (best >= 0) {
+        wifi_reconnect_connect(&stored.networks[best], NULL, 0);
+    }
 }
 
-// Get WiFi credentials from user
-static void get_wifi_credentials(void) {
-    printf("\n=== WiFi Configuration ===\n");
+// Store credentials, the associated AP and the lease for the next boot
+static void save_connection(void) {
+    wifi_config_t wifi_config;
+    wifi_ap_record_t ap_info;
     
-    read_uart_input(ssid, WIFI_SSID_MAX_LEN, "Enter WiFi SSID: ");
-    if (strlen(ssid) == 0) {
-        ESP_LOGE(TAG, "SSID cannot be empty!");
+    // The policy may have joined any known network; record the one in use
+    if (esp_wifi_get_config(WIFI_IF_STA, &wifi_config) != ESP_OK) {
         return;
     }
+    char current_ssid[WIFI_SSID_MAX_LEN] = {0};
+    char current_password[WIFI_PASS_MAX_LEN] = {0};
+    strncpy(current_ssid, (const char*)wifi_config.sta.ssid, sizeof(current_ssid) - 1);
+    strncpy(current_password, (const char*)wifi_config.sta.password, sizeof(current_password) - 1);
     
-    read_uart_input(password, WIFI_PASS_MAX_LEN, "Enter WiFi Password: ");
+    xSemaphoreTake(store_mutex, portMAX_DELAY);
+    int index = wifi_store_find_network(&stored, current_ssid);
+    uint8_t priority = (index >= 0) ? stored.networks[index].priority : WIFI_DEFAULT_PRIORITY;
+    stored.last = wifi_store_add_network(&stored, current_ssid, current_password, priority);
+    stored.has_ap = false;
     
-    ESP_LOGI(TAG, "WiFi credentials received - SSID: %s", ssid);
-}
-
-// Connect to WiFi with provided credentials
-static void connect_to_wifi(void) {
-    wifi_config_t wifi_config = {0};
+    if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
+        stored.has_ap = true;
+        memcpy(stored.bssid, ap_info.bssid, sizeof(stored.bssid));
+        stored.channel = ap_info.primary;
+    }
     
-    strncpy((char*)wifi_config.sta.ssid, ssid, sizeof(wifi_config.sta.ssid) - 1);
-    strncpy((char*)wifi_config.sta.password, password, sizeof(wifi_config.sta.password) - 1);
+    // Only an address handed out by a DHCP server is a lease
+    ip_config_timing_t timing;
+    ip_config_get_timing(&timing);
     
-    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
-    ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
-    ESP_ERROR_CHECK(esp_wifi_start());
+    stored.has_lease = stored.has_ap && last_ip_info.ip.addr != 0 &&
+                       (timing.mode == IP_MODE_DHCP || timing.mode == IP_MODE_CACHED_LEASE);
+    stored.lease = last_ip_info;
     
-    ESP_LOGI(TAG, "Attempting to connect to WiFi network: %s", ssid);
+    wifi_store_save(&stored);
+    xSemaphoreGive(store_mutex);
 }
 
 // Initialize WiFi station mode
 static void init_wifi_station(void) {
-    // Initialize NVS
-    esp_err_t ret = nvs_flash_init();
-    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        ret = nvs_flash_init();
-    }
-    ESP_ERROR_CHECK(ret);
-
+    store_mutex = xSemaphoreCreateMutexStatic(&store_mutex_buffer);
+    configASSERT(store_mutex != NULL);
+    
     // Initialize network interface
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
+    sta_netif = esp_netif_create_default_wifi_sta();
+    ip_config_init(sta_netif);
 
     // Initialize WiFi
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
     ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
+    power_save_init();
+    wifi_reconnect_init();
 
     // Register event handlers
     ESP_ERROR_CHECK(esp_event_handler_instance_register(WIFI_EVENT,
@@ -129,46 +141,83 @@ static void init_wifi_station(void) {
                                                         &wifi_event_handler,
                                                         NULL, NULL));
     ESP_ERROR_CHECK(esp_event_handler_instance_register(IP_EVENT,
-                                                        IP_EVENT_STA_GOT_IP,
+                                                        ESP_EVENT_ANY_ID,
                                                         &ip_event_handler,
                                                         NULL, NULL));
+    
+    // Connecting is left to wifi_task and the reconnect policy
+    ESP_ERROR_CHECK(esp_wifi_start());
+}
+
+esp_err_t wifi_config_add_network(const char *ssid, const char *password, uint8_t priority) {
+    if (store_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (ssid[0] == '\0' || strlen(ssid) >= WIFI_SSID_MAX_LEN ||
+        strlen(password) >= WIFI_PASS_MAX_LEN) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    xSemaphoreTake(store_mutex, portMAX_DELAY);
+    int index = wifi_store_add_network(&stored, ssid, password, priority);
+    esp_err_t err = wifi_store_save(&stored);
+    wifi_reconnect_set_networks(stored.networks, WIFI_KNOWN_NETWORKS_MAX);
+    
+    // Join it right away unless already online
+    if (!net_state_is(NET_LINK_UP)) {
+        wifi_reconnect_connect(&stored.networks[index], NULL, 0);
+    }
+    xSemaphoreGive(store_mutex);
+    
+    ESP_LOGI(TAG, "Known network %s added (priority %d)", ssid, priority);
+    return err;
+}
+
+esp_err_t wifi_config_forget_networks(void) {
+    if (store_mutex == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    xSemaphoreTake(store_mutex, portMAX_DELAY);
+    memset(&stored, 0, sizeof(stored));
+    stored.last = -1;
+    wifi_reconnect_set_networks(stored.networks, WIFI_KNOWN_NETWORKS_MAX);
+    esp_err_t err = wifi_store_clear();
+    xSemaphoreGive(store_mutex);
+    return err;
+}
+
+void wifi_config_reconnect(void) {
+    ESP_LOGI(TAG, "Reconnect requested");
+    esp_wifi_disconnect();
 }
 
 // Main WiFi configuration task
 void wifi_task(void *param) {
     ESP_LOGI(TAG, "WiFi configuration task started");
     
-    // Initialize components
-    init_uart();
     init_wifi_station();
     
-    // Get credentials and connect
-    get_wifi_credentials();
-    
-    if (strlen(ssid) > 0) {
-        connect_to_wifi();
-        
-        // Wait for connection
-        int retry_count = 0;
-        const int max_retries = 30; // 30 seconds timeout
-        
-        while (!wifi_connected && retry_count < max_retries) {
-            ESP_LOGI(TAG, "Waiting for WiFi connection... (%d/%d)", 
-                     retry_count + 1, max_retries);
-            vTaskDelay(pdMS_TO_TICKS(1000));
-            retry_count++;
-        }
-        
-        if (wifi_connected) {
-            ESP_LOGI(TAG, "WiFi configuration completed successfully");
-        } else {
-            ESP_LOGE(TAG, "Failed to connect to WiFi after %d seconds", max_retries);
+    // Start straight away with the stored networks; the reconnect policy
+    // takes over if the cached AP is gone
+    xSemaphoreTake(store_mutex, portMAX_DELAY);
+    if (wifi_store_load(&stored)) {
+        wifi_reconnect_set_networks(stored.networks, WIFI_KNOWN_NETWORKS_MAX);
+        if (stored.has_ap && stored.has_lease) {
+            ip_config_set_cached_lease(stored.bssid, &stored.lease);
         }
+        connect_stored();
     } else {
-        ESP_LOGE(TAG, "Invalid WiFi credentials provided");
+        ESP_LOGW(TAG, "No stored WiFi network, add one on the console: wifi_add <ssid> <password>");
     }
+    xSemaphoreGive(store_mutex);
+    
+    // Remember the AP and lease of the first connection for the next boot
+    net_state_wait(NET_GOT_IP, NET_WAIT_FOREVER);
+    ESP_LOGI(TAG, "WiFi configuration completed successfully");
+    save_connection();
     
     // Task cleanup
     ESP_LOGI(TAG, "WiFi configuration task terminating");
-    vTaskDelete(NULL);
-}
\ No newline at end of file
+    task_plan_exit(TASK_PLAN_WIFI);
+}
@@ -6,10 +6,27 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
-#include "nvs_flash.h"
-#include "driver/uart.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include "global_data.h"
+#include "net_state.h"
+#include "time_sync.h"
+#include "wifi_store.h"
+#include "wifi_reconnect.h"
+#include "ip_config.h"
+#include "power_save.h"
+#include "task_plan.h"
 
 void wifi_task(void *param);
 
+// Add or update a known network, save it and join it if offline
+esp_err_t wifi_config_add_network(const char *ssid, const char *password, uint8_t priority);
+
+// Erase all stored networks, the cached AP and lease
+esp_err_t wifi_config_forget_networks(void);
+
+// Drop the current association; the reconnect policy picks the best AP again
+void wifi_config_reconnect(void);
+
 #endif // WIFI_CONFIG_H
\ No newline at end of file
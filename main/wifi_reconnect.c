@@ -0,0 +1,247 @@
+#include "wifi_reconnect.h"
+
+static const char *TAG = "WIFI_RECONNECT";
+
+static wifi_network_t networks[WIFI_KNOWN_NETWORKS_MAX];
+static int network_count = 0;
+static portMUX_TYPE state_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static esp_timer_handle_t retry_timer = NULL;
+static uint32_t attempt = 0;
+static bool connected = false;  // Had an IP since the last disconnect
+static bool switching = false;  // Our own disconnect while moving to another AP
+static bool roam_scan = false;  // Current scan looks for a better AP
+static int64_t outage_start_us = 0;
+static int64_t last_roam_us = 0;
+static wifi_reconnect_stats_t stats;
+
+static wifi_ap_record_t scan_records[WIFI_SCAN_MAX_RECORDS];
+
+void wifi_reconnect_set_networks(const wifi_network_t *list, int count) {
+    portENTER_CRITICAL(&state_lock);
+    memset(networks, 0, sizeof(networks));
+    network_count = 0;
+    for (int i = 0; i < count && network_count < WIFI_KNOWN_NETWORKS_MAX; i++) {
+        if (list[i].ssid[0] != '\0') {
+            networks[network_count++] = list[i];
+        }
+    }
+    portEXIT_CRITICAL(&state_lock);
+}
+
+void wifi_reconnect_connect(const wifi_network_t *network, const uint8_t *bssid,
+                            uint8_t channel) {
+    wifi_config_t wifi_config = {0};
+
+    strncpy((char*)wifi_config.sta.ssid, network->ssid, sizeof(wifi_config.sta.ssid) - 1);
+    strncpy((char*)wifi_config.sta.password, network->password, sizeof(wifi_config.sta.password) - 1);
+    wifi_config.sta.listen_interval = WIFI_LISTEN_INTERVAL;
+
+    // Known BSSID and channel skip the all-channel scan
+    if (bssid != NULL) {
+        wifi_config.sta.bssid_set = true;
+        memcpy(wifi_config.sta.bssid, bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.channel = channel;
+        wifi_config.sta.scan_method = WIFI_FAST_SCAN;
+        ESP_LOGI(TAG, "Connecting to %s (AP " MACSTR ", channel %d)",
+                 network->ssid, MAC2STR(bssid), channel);
+    } else {
+        ESP_LOGI(TAG, "Connecting to %s", network->ssid);
+    }
+
+    if (connected) {
+        switching = true;
+        esp_wifi_disconnect();
+    }
+    esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+    esp_wifi_connect();
+}
+
+// Next retry delay: exponential backoff with +/- jitter to avoid lockstep retries
+static uint32_t backoff_delay_ms(uint32_t n) {
+    uint32_t delay = WIFI_BACKOFF_BASE_MS << (n > 16 ? 16 : n);
+    if (delay > WIFI_BACKOFF_MAX_MS) {
+        delay = WIFI_BACKOFF_MAX_MS;
+    }
+    uint32_t jitter = delay * WIFI_BACKOFF_JITTER_PCT / 100;
+    return delay - jitter + esp_random() % (2 * jitter + 1);
+}
+
+static void schedule_retry(void) {
+    uint32_t delay_ms = backoff_delay_ms(attempt++);
+    esp_timer_stop(retry_timer);
+    esp_timer_start_once(retry_timer, (uint64_t)delay_ms * 1000);
+    ESP_LOGI(TAG, "Reconnect attempt %u in %u ms", attempt, delay_ms);
+}
+
+// Retry/roam timer: scan for the best known AP (or just retry without a list)
+static void retry_timer_callback(void *arg) {
+    portENTER_CRITICAL(&state_lock);
+    bool have_networks = (network_count > 0);
+    bool roaming = connected;
+    roam_scan = roaming;
+    if (!roaming) {
+        stats.reconnect_attempts++;
+    }
+    portEXIT_CRITICAL(&state_lock);
+
+    if (have_networks && esp_wifi_scan_start(NULL, false) == ESP_OK) {
+        return;
+    }
+    if (!roaming) {
+        esp_wifi_connect();
+    }
+}
+
+// Create the retry timer (startup, before the first disconnect)
+void wifi_reconnect_init(void) {
+    const esp_timer_create_args_t args = {
+        .callback = retry_timer_callback,
+        .name = "wifi_retry"
+    };
+    ESP_ERROR_CHECK(static_mem_timer_create(&args, &retry_timer));
+}
+
+// Pick the best known AP from the scan: highest priority, then strongest signal
+static int select_best(int count, wifi_network_t *network) {
+    int best = -1;
+    int best_priority = -1;
+
+    portENTER_CRITICAL(&state_lock);
+    for (int i = 0; i < count; i++) {
+        if (scan_records[i].rssi < WIFI_MIN_RSSI) {
+            continue;
+        }
+        for (int n = 0; n < network_count; n++) {
+            if (strcmp((const char*)scan_records[i].ssid, networks[n].ssid) != 0) {
+                continue;
+            }
+            if (networks[n].priority > best_priority ||
+                (networks[n].priority == best_priority && scan_records[i].rssi > scan_records[best].rssi)) {
+                best = i;
+                best_priority = networks[n].priority;
+                *network = networks[n];
+            }
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&state_lock);
+    return best;
+}
+
+// Move to a clearly stronger AP if the scan found one
+static void evaluate_roam(int best, const wifi_network_t *network) {
+    wifi_ap_record_t current;
+
+    if (best >= 0 && esp_wifi_sta_get_ap_info(&current) == ESP_OK &&
+        memcmp(current.bssid, scan_records[best].bssid, sizeof(current.bssid)) != 0 &&
+        scan_records[best].rssi >= current.rssi + WIFI_ROAM_HYSTERESIS) {
+        ESP_LOGW(TAG, "Roaming from " MACSTR " (%d dBm) to " MACSTR " (%d dBm)",
+                 MAC2STR(current.bssid), current.rssi,
+                 MAC2STR(scan_records[best].bssid), scan_records[best].rssi);
+
+        portENTER_CRITICAL(&state_lock);
+        stats.roams++;
+        portEXIT_CRITICAL(&state_lock);
+        wifi_reconnect_connect(network, scan_records[best].bssid, scan_records[best].primary);
+        return;
+    }
+
+    // Staying put; re-arm the low signal event
+    esp_wifi_set_rssi_threshold(WIFI_ROAM_RSSI_THRESHOLD);
+}
+
+void wifi_reconnect_on_scan_done(void) {
+    uint16_t count = WIFI_SCAN_MAX_RECORDS;
+    wifi_network_t network;
+
+    if (esp_wifi_scan_get_ap_records(&count, scan_records) != ESP_OK) {
+        count = 0;
+    }
+    int best = select_best(count, &network);
+
+    if (roam_scan) {
+        roam_scan = false;
+        evaluate_roam(best, &network);
+        return;
+    }
+    if (connected) {
+        return;
+    }
+
+    if (best >= 0) {
+        wifi_reconnect_connect(&network, scan_records[best].bssid, scan_records[best].primary);
+    } else {
+        ESP_LOGW(TAG, "No known network in range (%d APs seen)", count);
+        schedule_retry();
+    }
+}
+
+void wifi_reconnect_on_disconnected(const wifi_event_sta_disconnected_t *event) {
+
+    // Our own disconnect before joining another AP; the connect is already issued
+    if (switching && event->reason == WIFI_REASON_ASSOC_LEAVE) {
+        switching = false;
+        return;
+    }
+
+    portENTER_CRITICAL(&state_lock);
+    if (connected) {
+        connected = false;
+        outage_start_us = esp_timer_get_time();
+        stats.disconnects++;
+    }
+    portEXIT_CRITICAL(&state_lock);
+
+    ESP_LOGW(TAG, "Disconnected (reason %d)", event->reason);
+    schedule_retry();
+}
+
+void wifi_reconnect_on_rssi_low(void) {
+    int64_t now = esp_timer_get_time();
+    int64_t wait_us = last_roam_us + (int64_t)WIFI_ROAM_MIN_INTERVAL_MS * 1000 - now;
+
+    ESP_LOGI(TAG, "Signal below %d dBm, looking for a better AP", WIFI_ROAM_RSSI_THRESHOLD);
+
+    // Rate-limit roam scans; the timer starts the scan
+    last_roam_us = (wait_us > 0) ? now + wait_us : now;
+    esp_timer_stop(retry_timer);
+    esp_timer_start_once(retry_timer, wait_us > 0 ? (uint64_t)wait_us : 1000);
+}
+
+void wifi_reconnect_on_got_ip(void) {
+    int64_t now = esp_timer_get_time();
+
+    if (retry_timer != NULL) {
+        esp_timer_stop(retry_timer);
+    }
+
+    portENTER_CRITICAL(&state_lock);
+    connected = true;
+    switching = false;
+    attempt = 0;
+    uint32_t outage_ms = 0;
+    if (outage_start_us != 0) {
+        outage_ms = (uint32_t)((now - outage_start_us) / 1000);
+        stats.last_outage_ms = outage_ms;
+        stats.total_outage_ms += outage_ms;
+        if (outage_ms > stats.max_outage_ms) {
+            stats.max_outage_ms = outage_ms;
+        }
+        outage_start_us = 0;
+    }
+    portEXIT_CRITICAL(&state_lock);
+
+    if (outage_ms > 0) {
+        ESP_LOGI(TAG, "Reconnected after %u ms outage", outage_ms);
+    }
+
+    // Arm the low signal event for roaming
+    esp_wifi_set_rssi_threshold(WIFI_ROAM_RSSI_THRESHOLD);
+}
+
+void wifi_reconnect_get_stats(wifi_reconnect_stats_t *out) {
+    portENTER_CRITICAL(&state_lock);
+    *out = stats;
+    portEXIT_CRITICAL(&state_lock);
+}
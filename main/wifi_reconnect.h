@@ -0,0 +1,56 @@
+// wifi_reconnect.h
+#ifndef WIFI_RECONNECT_H
+#define WIFI_RECONNECT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "static_mem.h"
+#include "esp_wifi.h"
+#include "wifi_store.h"
+#include "power_save.h"
+
+// Reconnect backoff: base * 2^attempt, capped, with +/- jitter
+#define WIFI_BACKOFF_BASE_MS 500
+#define WIFI_BACKOFF_MAX_MS 60000
+#define WIFI_BACKOFF_JITTER_PCT 25
+
+// AP selection and roaming
+#define WIFI_SCAN_MAX_RECORDS 16
+#define WIFI_MIN_RSSI -88            // Ignore APs weaker than this
+#define WIFI_ROAM_RSSI_THRESHOLD -75 // RSSI_LOW event level that starts a roam scan
+#define WIFI_ROAM_HYSTERESIS 8       // Candidate must be this many dB stronger
+#define WIFI_ROAM_MIN_INTERVAL_MS 30000
+#define WIFI_DEFAULT_PRIORITY 10     // Priority of networks entered by the user
+
+typedef struct {
+    uint32_t disconnects;
+    uint32_t reconnect_attempts;
+    uint32_t roams;
+    uint32_t last_outage_ms;
+    uint32_t max_outage_ms;
+    uint64_t total_outage_ms;
+} wifi_reconnect_stats_t;
+
+void wifi_reconnect_init(void);
+
+// Replace the known network list (copied)
+void wifi_reconnect_set_networks(const wifi_network_t *networks, int count);
+
+// Connect to a network, optionally pinned to a BSSID/channel (NULL = any AP)
+void wifi_reconnect_connect(const wifi_network_t *network, const uint8_t *bssid,
+                            uint8_t channel);
+
+// Feed WiFi/IP events into the policy (called from the event handlers)
+void wifi_reconnect_on_disconnected(const wifi_event_sta_disconnected_t *event);
+void wifi_reconnect_on_scan_done(void);
+void wifi_reconnect_on_rssi_low(void);
+void wifi_reconnect_on_got_ip(void);
+
+void wifi_reconnect_get_stats(wifi_reconnect_stats_t *stats);
+
+#endif // WIFI_RECONNECT_H
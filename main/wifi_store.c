@@ -0,0 +1,163 @@
+#include "wifi_store.h"
+
+#define WIFI_STORE_KEY "state"
+#define WIFI_STATIC_IP_KEY "static_ip"
+
+static const char *TAG = "WIFI_STORE";
+
+bool wifi_store_load(wifi_stored_config_t *cfg) {
+    nvs_handle_t handle;
+    size_t size = sizeof(*cfg);
+
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->last = -1;
+    if (nvs_open(WIFI_STORE_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    esp_err_t err = nvs_get_blob(handle, WIFI_STORE_KEY, cfg, &size);
+    nvs_close(handle);
+
+    if (err != ESP_OK || size != sizeof(*cfg) || cfg->version != WIFI_STORE_VERSION) {
+        memset(cfg, 0, sizeof(*cfg));
+        cfg->last = -1;
+        return false;
+    }
+
+    bool any = false;
+    for (int i = 0; i < WIFI_KNOWN_NETWORKS_MAX; i++) {
+        cfg->networks[i].ssid[sizeof(cfg->networks[i].ssid) - 1] = '\0';
+        cfg->networks[i].password[sizeof(cfg->networks[i].password) - 1] = '\0';
+        any |= (cfg->networks[i].ssid[0] != '\0');
+    }
+    // The cached AP is only usable together with its network
+    if (cfg->last < 0 || cfg->last >= WIFI_KNOWN_NETWORKS_MAX ||
+        cfg->networks[cfg->last].ssid[0] == '\0') {
+        cfg->last = -1;
+        cfg->has_ap = false;
+        cfg->has_lease = false;
+    }
+    return any;
+}
+
+int wifi_store_find_network(const wifi_stored_config_t *cfg, const char *ssid) {
+    for (int i = 0; i < WIFI_KNOWN_NETWORKS_MAX; i++) {
+        if (cfg->networks[i].ssid[0] != '\0' && strcmp(cfg->networks[i].ssid, ssid) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int wifi_store_add_network(wifi_stored_config_t *cfg, const char *ssid,
+                           const char *password, uint8_t priority) {
+    int index = wifi_store_find_network(cfg, ssid);
+
+    // Otherwise take a free slot, or evict the lowest priority network
+    if (index < 0) {
+        index = 0;
+        for (int i = 0; i < WIFI_KNOWN_NETWORKS_MAX; i++) {
+            if (cfg->networks[i].ssid[0] == '\0') {
+                index = i;
+                break;
+            }
+            if (cfg->networks[i].priority < cfg->networks[index].priority) {
+                index = i;
+            }
+        }
+        if (index == cfg->last) {
+            cfg->last = -1;
+            cfg->has_ap = false;
+            cfg->has_lease = false;
+        }
+    }
+
+    wifi_network_t *net = &cfg->networks[index];
+    memset(net, 0, sizeof(*net));
+    strncpy(net->ssid, ssid, sizeof(net->ssid) - 1);
+    strncpy(net->password, password, sizeof(net->password) - 1);
+    net->priority = priority;
+    return index;
+}
+
+esp_err_t wifi_store_save(const wifi_stored_config_t *cfg) {
+    wifi_stored_config_t current;
+    wifi_stored_config_t updated = *cfg;
+    nvs_handle_t handle;
+    size_t size = sizeof(current);
+
+    updated.version = WIFI_STORE_VERSION;
+
+    esp_err_t err = nvs_open(WIFI_STORE_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to open NVS: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    // Avoid flash wear when reconnecting to the same AP with the same lease
+    if (nvs_get_blob(handle, WIFI_STORE_KEY, &current, &size) == ESP_OK &&
+        size == sizeof(current) && memcmp(&current, &updated, sizeof(updated)) == 0) {
+        nvs_close(handle);
+        return ESP_OK;
+    }
+
+    err = nvs_set_blob(handle, WIFI_STORE_KEY, &updated, sizeof(updated));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save WiFi state: %s", esp_err_to_name(err));
+    } else {
+        ESP_LOGI(TAG, "WiFi state saved");
+    }
+    return err;
+}
+
+esp_err_t wifi_store_clear(void) {
+    nvs_handle_t handle;
+
+    esp_err_t err = nvs_open(WIFI_STORE_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_erase_key(handle, WIFI_STORE_KEY);
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
+
+bool wifi_store_load_static_ip(wifi_static_ip_t *cfg) {
+    nvs_handle_t handle;
+    size_t size = sizeof(*cfg);
+
+    memset(cfg, 0, sizeof(*cfg));
+    if (nvs_open(WIFI_STORE_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return false;
+    }
+    esp_err_t err = nvs_get_blob(handle, WIFI_STATIC_IP_KEY, cfg, &size);
+    nvs_close(handle);
+
+    if (err != ESP_OK || size != sizeof(*cfg)) {
+        memset(cfg, 0, sizeof(*cfg));
+        return false;
+    }
+    return true;
+}
+
+esp_err_t wifi_store_save_static_ip(const wifi_static_ip_t *cfg) {
+    nvs_handle_t handle;
+
+    esp_err_t err = nvs_open(WIFI_STORE_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_blob(handle, WIFI_STATIC_IP_KEY, cfg, sizeof(*cfg));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    return err;
+}
@@ -0,0 +1,62 @@
+// wifi_store.h
+#ifndef WIFI_STORE_H
+#define WIFI_STORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_netif.h"
+#include "nvs.h"
+#include "global_data.h"
+
+#define WIFI_STORE_NAMESPACE "wifi"
+#define WIFI_STORE_VERSION 2
+#define WIFI_KNOWN_NETWORKS_MAX 4
+
+// A known network; higher priority is preferred when several are in range
+typedef struct {
+    char ssid[WIFI_SSID_MAX_LEN];
+    char password[WIFI_PASS_MAX_LEN];
+    uint8_t priority;
+} wifi_network_t;
+
+// Network state kept in NVS between boots
+typedef struct {
+    uint8_t version;
+    wifi_network_t networks[WIFI_KNOWN_NETWORKS_MAX]; // Unused entries have an empty SSID
+    int8_t last;              // Network the cached AP belongs to (-1 = none)
+    bool has_ap;              // bssid/channel of the last AP are valid
+    uint8_t bssid[6];
+    uint8_t channel;
+    bool has_lease;           // Last DHCP lease is valid (belongs to the cached AP)
+    esp_netif_ip_info_t lease;
+} wifi_stored_config_t;
+
+// Static addressing; an all-zero ip selects DHCP
+typedef struct {
+    esp_netif_ip_info_t info;
+    esp_ip4_addr_t dns;
+} wifi_static_ip_t;
+
+// Load stored state; returns false if no network is stored
+bool wifi_store_load(wifi_stored_config_t *cfg);
+
+// Add or update a network in cfg (not saved). A full list replaces its lowest
+// priority entry. Returns the index used.
+int wifi_store_add_network(wifi_stored_config_t *cfg, const char *ssid,
+                           const char *password, uint8_t priority);
+
+int wifi_store_find_network(const wifi_stored_config_t *cfg, const char *ssid);
+
+// Save state (skips the flash write when nothing changed)
+esp_err_t wifi_store_save(const wifi_stored_config_t *cfg);
+
+esp_err_t wifi_store_clear(void);
+
+// Static IP settings stored separately from the network list
+bool wifi_store_load_static_ip(wifi_static_ip_t *cfg);
+esp_err_t wifi_store_save_static_ip(const wifi_static_ip_t *cfg);
+
+#endif // WIFI_STORE_H
@@ -0,0 +1,186 @@
+// batch_decode.c - host decoder for history batches (see main/batch_codec.h)
+//
+// Build:  cc -O2 -I../../main -o batch_decode batch_decode.c ../../main/batch_codec.c
+//
+// Decode: batch_decode [file]          base64 batches, one per line -> CSV
+// Encode: batch_decode -e trace.csv [-n 60]
+//         CSV trace "time_ms,temperature,humidity" -> base64 batches, one per line
+//
+// Both modes print compression statistics to stderr.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "batch_codec.h"
+
+#define MAX_SAMPLES 4096
+#define MAX_LINE 8192
+
+static batch_sample_t samples[MAX_SAMPLES];
+static uint8_t scratch[BATCH_RAW_MAX(MAX_SAMPLES)];
+static uint8_t binary[BATCH_RAW_MAX(MAX_SAMPLES) * 2];
+static char line[MAX_LINE];
+
+typedef struct {
+    size_t batches;
+    size_t samples;
+    size_t encoded_bytes; // Compressed binary
+    size_t text_bytes;    // Base64 payload actually published
+    size_t per_sample_bytes; // One "%.1f" message per reading, as without batching
+} codec_stats_t;
+
+// Size of publishing one sample as two plain-text messages (temperature, humidity)
+static size_t per_sample_text_size(const batch_sample_t *s) {
+    char buf[32];
+    return (size_t)snprintf(buf, sizeof(buf), "%.1f", s->temperature_x10 / 10.0) +
+           (size_t)snprintf(buf, sizeof(buf), "%.1f", s->humidity_x10 / 10.0);
+}
+
+static void print_stats(const codec_stats_t *st) {
+    size_t fixed = st->samples * (8 + 2 + 2); // u64 timestamp + two int16 readings
+    fprintf(stderr, "batches: %zu, samples: %zu\n", st->batches, st->samples);
+    fprintf(stderr, "fixed binary:  %zu bytes\n", fixed);
+    fprintf(stderr, "compressed:    %zu bytes (ratio %.2f)\n", st->encoded_bytes,
+            st->encoded_bytes ? (double)fixed / st->encoded_bytes : 0.0);
+    fprintf(stderr, "base64 text:   %zu bytes (ratio %.2f)\n", st->text_bytes,
+            st->text_bytes ? (double)fixed / st->text_bytes : 0.0);
+    fprintf(stderr, "per-sample messages: %zu, payload bytes: %zu\n",
+            st->samples * 2, st->per_sample_bytes);
+}
+
+// Strip trailing whitespace / newline
+static size_t trim(char *s) {
+    size_t len = strlen(s);
+    while (len > 0 && (s[len - 1] == '\n' || s[len - 1] == '\r' ||
+                       s[len - 1] == ' ' || s[len - 1] == '\t')) {
+        s[--len] = '\0';
+    }
+    return len;
+}
+
+static int decode_stream(FILE *in) {
+    codec_stats_t st = {0};
+
+    printf("time_ms,temperature,humidity,synced\n");
+    while (fgets(line, sizeof(line), in) != NULL) {
+        size_t len = trim(line);
+        if (len == 0) {
+            continue;
+        }
+
+        size_t bin_len = batch_base64_decode(line, len, binary, sizeof(binary));
+        uint64_t base_time_ms;
+        uint8_t flags;
+        int count = bin_len ? batch_decode(binary, bin_len, &base_time_ms, &flags,
+                                           scratch, sizeof(scratch), samples, MAX_SAMPLES) : -1;
+        if (count < 0) {
+            fprintf(stderr, "skipping malformed batch: %.40s...\n", line);
+            continue;
+        }
+
+        for (int i = 0; i < count; i++) {
+            printf("%llu,%.1f,%.1f,%d\n",
+                   (unsigned long long)(base_time_ms + samples[i].offset_ms),
+                   samples[i].temperature_x10 / 10.0, samples[i].humidity_x10 / 10.0,
+                   (flags & BATCH_FLAG_TIME_SYNCED) ? 1 : 0);
+            st.per_sample_bytes += per_sample_text_size(&samples[i]);
+        }
+
+        st.batches++;
+        st.samples += count;
+        st.encoded_bytes += bin_len;
+        st.text_bytes += len;
+    }
+
+    print_stats(&st);
+    return 0;
+}
+
+// Encode and emit one batch of buffered samples
+static int flush_batch(size_t count, uint64_t base_time_ms, codec_stats_t *st) {
+    static char text[sizeof(binary) * 4 / 3 + 4];
+
+    size_t len = batch_encode(samples, count, base_time_ms, BATCH_FLAG_TIME_SYNCED,
+                              scratch, sizeof(scratch), binary, sizeof(binary));
+    size_t text_len = len ? batch_base64_encode(binary, len, text, sizeof(text)) : 0;
+    if (text_len == 0) {
+        fprintf(stderr, "batch encoding failed\n");
+        return -1;
+    }
+
+    printf("%s\n", text);
+    for (size_t i = 0; i < count; i++) {
+        st->per_sample_bytes += per_sample_text_size(&samples[i]);
+    }
+    st->batches++;
+    st->samples += count;
+    st->encoded_bytes += len;
+    st->text_bytes += text_len;
+    return 0;
+}
+
+static int encode_trace(FILE *in, size_t batch_size) {
+    codec_stats_t st = {0};
+    size_t count = 0;
+    uint64_t base_time_ms = 0;
+
+    while (fgets(line, sizeof(line), in) != NULL) {
+        unsigned long long time_ms;
+        double temp, hum;
+        if (sscanf(line, "%llu,%lf,%lf", &time_ms, &temp, &hum) != 3) {
+            continue; // Header or comment
+        }
+
+        if (count == 0) {
+            base_time_ms = time_ms;
+        }
+        samples[count].offset_ms = (uint32_t)(time_ms - base_time_ms);
+        samples[count].temperature_x10 = (int16_t)(temp * 10.0 + (temp >= 0 ? 0.5 : -0.5));
+        samples[count].humidity_x10 = (int16_t)(hum * 10.0 + (hum >= 0 ? 0.5 : -0.5));
+        count++;
+
+        if (count == batch_size) {
+            if (flush_batch(count, base_time_ms, &st) != 0) {
+                return 1;
+            }
+            count = 0;
+        }
+    }
+    if (count > 0 && flush_batch(count, base_time_ms, &st) != 0) {
+        return 1;
+    }
+
+    print_stats(&st);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const char *path = NULL;
+    bool encode = false;
+    size_t batch_size = 60;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-e") == 0) {
+            encode = true;
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            batch_size = strtoul(argv[++i], NULL, 10);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (batch_size == 0 || batch_size > MAX_SAMPLES) {
+        fprintf(stderr, "batch size must be 1..%d\n", MAX_SAMPLES);
+        return 1;
+    }
+
+    FILE *in = path ? fopen(path, "r") : stdin;
+    if (in == NULL) {
+        perror(path);
+        return 1;
+    }
+
+    int ret = encode ? encode_trace(in, batch_size) : decode_stream(in);
+    if (in != stdin) {
+        fclose(in);
+    }
+    return ret;
+}
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""Collect "BENCH {json}" lines from the serial monitor into a results file.
+
+Usage:
+    idf.py -p /dev/ttyUSB0 monitor | tee bench.log
+    python3 collect_results.py bench.log -o results.json [--baseline old.json]
+
+With --baseline, latency percentiles that grew (or throughput that dropped)
+by more than --tolerance percent are reported and the exit status is 1.
+"""
+import argparse
+import json
+import subprocess
+import sys
+import time
+
+LOWER_IS_BETTER = ("min_us", "p50_us", "p90_us", "p99_us", "max_us", "lost", "failed")
+HIGHER_IS_BETTER = ("msg_per_s",)
+
+
+def parse_log(lines):
+    results = {}
+    for line in lines:
+        start = line.find("BENCH {")
+        if start < 0:
+            continue
+        try:
+            entry = json.loads(line[start + len("BENCH "):].strip())
+        except json.JSONDecodeError:
+            continue
+        results[entry["test"]] = entry
+    return results
+
+
+def git_revision():
+    try:
+        return subprocess.check_output(["git", "rev-parse", "--short", "HEAD"],
+                                       text=True).strip()
+    except (OSError, subprocess.CalledProcessError):
+        return "unknown"
+
+
+def compare(results, baseline, tolerance):
+    regressions = []
+    for test, entry in results.items():
+        old = baseline.get(test)
+        if old is None:
+            continue
+        for key in LOWER_IS_BETTER + HIGHER_IS_BETTER:
+            if key not in entry or key not in old or old[key] == 0:
+                continue
+            change = (entry[key] - old[key]) * 100.0 / old[key]
+            if key in HIGHER_IS_BETTER:
+                change = -change
+            if change > tolerance:
+                regressions.append(f"{test}.{key}: {old[key]} -> {entry[key]} ({change:+.1f}%)")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("log", nargs="?", default="-", help="monitor log (default: stdin)")
+    parser.add_argument("-o", "--output", default="bench_results.json")
+    parser.add_argument("--baseline", help="previous results file to compare against")
+    parser.add_argument("--tolerance", type=float, default=10.0, help="allowed change in percent")
+    args = parser.parse_args()
+
+    stream = sys.stdin if args.log == "-" else open(args.log, encoding="utf-8", errors="replace")
+    results = parse_log(stream)
+    if not results:
+        print("no BENCH lines found", file=sys.stderr)
+        return 2
+
+    report = {
+        "timestamp": int(time.time()),
+        "revision": git_revision(),
+        "results": results,
+    }
+    with open(args.output, "w", encoding="utf-8") as out:
+        json.dump(report, out, indent=2, sort_keys=True)
+    print(f"wrote {len(results)} results to {args.output}")
+
+    if args.baseline:
+        with open(args.baseline, encoding="utf-8") as f:
+            baseline = json.load(f)["results"]
+        regressions = compare(results, baseline, args.tolerance)
+        for line in regressions:
+            print("REGRESSION", line)
+        return 1 if regressions else 0
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,237 @@
+// prealarm_sim.c - host simulation of the trend pre-alarm (see main/trend_predict.h)
+//
+// Build:  cc -O2 -I../../main -o prealarm_sim prealarm_sim.c ../../main/trend_predict.c
+//
+// Replay: prealarm_sim [options] trace.csv...
+//         CSV trace "time_ms,temperature,humidity" (as for batch_decode -e);
+//         lines that do not parse are skipped, -99 readings count as failed reads
+// Synth:  prealarm_sim [options] -g 200 [-s seed] [-o synth.csv]
+//         generated trace with real and false heat-ups at DHT11 resolution
+//
+// Options: -c critical °C (40)  -y hysteresis °C (1)  -k critical hold ms (2000)
+//          -H horizon s (120)   -w window samples (45)
+//
+// Reports how much earlier the pre-alarm fires than the threshold alarm and
+// the share of pre-alarms that were not followed by one.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "trend_predict.h"
+
+#define MAX_LINE 256
+#define SYNTH_PERIOD_MS 2000
+
+typedef struct {
+    float critical;
+    float hysteresis;
+    uint32_t hold_ms;
+    float horizon_s;
+    uint16_t window;
+} sim_config_t;
+
+typedef struct {
+    prealarm_t prealarm;
+    bool alarm;          // Threshold alarm (as alarm_monitor's critical level)
+    bool above;
+    uint32_t above_since;
+    bool cleared_once;
+    uint32_t cleared_ms;
+    bool pending;        // Pre-alarm raised, outcome not known yet
+    uint32_t raised_ms;
+} sim_state_t;
+
+typedef struct {
+    unsigned samples;
+    unsigned alarms;
+    unsigned predicted;
+    unsigned missed;
+    unsigned prealarms;
+    unsigned false_positives;
+    double lead_sum_s;
+    double lead_min_s;
+    double lead_max_s;
+} sim_stats_t;
+
+static sim_config_t cfg = { 40.0f, 1.0f, 2000, 120.0f, 45 };
+static sim_stats_t stats = { .lead_min_s = 1e9 };
+
+static void sim_reset(sim_state_t *st) {
+    memset(st, 0, sizeof(*st));
+    prealarm_init(&st->prealarm, cfg.window);
+}
+
+static void sim_sample(sim_state_t *st, uint32_t time_ms, float temp) {
+    stats.samples++;
+    if (temp <= -99.0f) {
+        return;
+    }
+
+    // Threshold alarm with hold time and hysteresis
+    bool above = st->alarm ? temp > cfg.critical - cfg.hysteresis : temp >= cfg.critical;
+    if (above && !st->above) {
+        st->above_since = time_ms;
+    }
+    st->above = above;
+    bool alarm = above && (st->alarm || time_ms - st->above_since >= cfg.hold_ms);
+
+    // Whole-degree readings can re-trigger the alarm within one heat-up; a
+    // new onset within the horizon of the last clear is the same episode
+    bool new_episode = !(st->cleared_once && time_ms - st->cleared_ms < (uint32_t)(cfg.horizon_s * 1000.0f));
+    if (!alarm && st->alarm) {
+        st->cleared_once = true;
+        st->cleared_ms = time_ms;
+    }
+    if (alarm && !st->alarm && new_episode) {
+        stats.alarms++;
+        if (st->pending) {
+            double lead = (time_ms - st->raised_ms) / 1000.0;
+            stats.predicted++;
+            stats.lead_sum_s += lead;
+            stats.lead_min_s = lead < stats.lead_min_s ? lead : stats.lead_min_s;
+            stats.lead_max_s = lead > stats.lead_max_s ? lead : stats.lead_max_s;
+            st->pending = false;
+        } else {
+            stats.missed++;
+        }
+    }
+    st->alarm = alarm;
+
+    // Pre-alarm, ignored while the threshold alarm is on (as on the device)
+    if (prealarm_update(&st->prealarm, time_ms, temp, cfg.critical, cfg.horizon_s, NULL) &&
+        st->prealarm.active && !st->alarm && !st->pending) {
+        stats.prealarms++;
+        st->pending = true;
+        st->raised_ms = time_ms;
+    }
+
+    // A cleared pre-alarm not followed by the alarm within the horizon was false
+    if (st->pending && !st->prealarm.active &&
+        time_ms - st->raised_ms > (uint32_t)(cfg.horizon_s * 1000.0f)) {
+        stats.false_positives++;
+        st->pending = false;
+    }
+}
+
+static int replay_file(const char *path) {
+    char line[MAX_LINE];
+    unsigned long long time_ms;
+    double temp, hum;
+    sim_state_t st;
+    FILE *in = fopen(path, "r");
+
+    if (in == NULL) {
+        perror(path);
+        return -1;
+    }
+    sim_reset(&st);
+    while (fgets(line, sizeof(line), in) != NULL) {
+        if (sscanf(line, "%llu,%lf,%lf", &time_ms, &temp, &hum) == 3) {
+            sim_sample(&st, (uint32_t)time_ms, (float)temp);
+        }
+    }
+    fclose(in);
+    return 0;
+}
+
+static double frand(double lo, double hi) {
+    return lo + (hi - lo) * rand() / (double)RAND_MAX;
+}
+
+// Idle periods around heat-ups: 60% reach critical at 0.5..3 °C/min, the rest
+// level off 1..4 °C below it; readings are whole degrees with 5% failed reads
+static void synthesize(int episodes, FILE *out) {
+    sim_state_t st;
+    uint32_t t = 0;
+    double temp = 30.0;
+
+    sim_reset(&st);
+    for (int e = 0; e < episodes; e++) {
+        double base = frand(26.0, 33.0);
+        bool real = frand(0.0, 1.0) < 0.6;
+        double peak = real ? cfg.critical + frand(1.0, 4.0) : cfg.critical - frand(1.0, 4.0);
+        double rate = frand(0.5, 3.0) / 60.0; // °C per second
+        int idle = (int)frand(300, 1200);
+        int plateau = (int)frand(60, 600);
+
+        for (int phase = 0; phase < 4; phase++) {
+            int steps = phase == 0 ? idle : phase == 2 ? plateau : 100000;
+            for (int i = 0; i < steps; i++, t += SYNTH_PERIOD_MS) {
+                double dt = SYNTH_PERIOD_MS / 1000.0;
+                if (phase == 0) {
+                    temp += (base - temp) * 0.05;
+                } else if (phase == 1) {
+                    temp += rate * dt;
+                    if (temp >= peak) {
+                        break;
+                    }
+                } else if (phase == 3) {
+                    temp -= rate * dt * 2.0;
+                    if (temp <= base) {
+                        break;
+                    }
+                }
+                float reading = frand(0.0, 1.0) < 0.05 ? -99.0f : (float)(int)(temp + frand(-0.3, 0.3) + 0.5);
+                if (out) {
+                    fprintf(out, "%u,%.1f,%.1f\n", t, reading, reading <= -99.0f ? -99.0 : 60.0);
+                }
+                sim_sample(&st, t, reading);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    int episodes = 0;
+    unsigned seed = 1;
+    const char *synth_path = NULL;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "c:y:k:H:w:g:s:o:")) != -1) {
+        switch (opt) {
+            case 'c': cfg.critical = strtof(optarg, NULL); break;
+            case 'y': cfg.hysteresis = strtof(optarg, NULL); break;
+            case 'k': cfg.hold_ms = strtoul(optarg, NULL, 10); break;
+            case 'H': cfg.horizon_s = strtof(optarg, NULL); break;
+            case 'w': cfg.window = (uint16_t)atoi(optarg); break;
+            case 'g': episodes = atoi(optarg); break;
+            case 's': seed = strtoul(optarg, NULL, 10); break;
+            case 'o': synth_path = optarg; break;
+            default:
+                fprintf(stderr, "usage: %s [-c C] [-y C] [-k ms] [-H s] [-w n] "
+                        "(-g episodes [-s seed] [-o out.csv] | trace.csv...)\n", argv[0]);
+                return 1;
+        }
+    }
+    if (episodes <= 0 && optind >= argc) {
+        fprintf(stderr, "no trace given (use -g to synthesize one)\n");
+        return 1;
+    }
+
+    if (episodes > 0) {
+        FILE *out = synth_path ? fopen(synth_path, "w") : NULL;
+        srand(seed);
+        synthesize(episodes, out);
+        if (out) {
+            fclose(out);
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        if (replay_file(argv[i]) < 0) {
+            return 1;
+        }
+    }
+
+    unsigned raised = stats.predicted + stats.false_positives;
+    printf("config: critical %.1f C, hysteresis %.1f C, hold %u ms, horizon %.0f s, window %u\n",
+           cfg.critical, cfg.hysteresis, cfg.hold_ms, cfg.horizon_s, cfg.window);
+    printf("samples: %u, threshold alarms: %u, predicted: %u, missed: %u\n",
+           stats.samples, stats.alarms, stats.predicted, stats.missed);
+    if (stats.predicted > 0) {
+        printf("lead time: mean %.1f s, min %.1f s, max %.1f s\n",
+               stats.lead_sum_s / stats.predicted, stats.lead_min_s, stats.lead_max_s);
+    }
+    printf("pre-alarms: %u, false positives: %u (%.1f%%)\n", stats.prealarms,
+           stats.false_positives, raised ? stats.false_positives * 100.0 / raised : 0.0);
+    return 0;
+}
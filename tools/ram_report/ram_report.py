@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""Report the static RAM used by each firmware subsystem from the linker map.
+
+Usage:
+    idf.py build
+    python3 tools/ram_report/ram_report.py build/Test_Tepbac.map [--budget 65536] [-v]
+
+DRAM (.data/.bss, including the static task stacks) and IRAM are summed per
+source file of the main component and grouped into subsystems; ESP-IDF and
+library archives are summed per component. With --budget, the exit status
+is 1 if the application DRAM total exceeds it.
+"""
+import argparse
+import re
+import sys
+from collections import defaultdict
+
+# Source file (without .c) -> subsystem
+SUBSYSTEMS = {
+    "tasks": ("main", "task_plan", "static_mem", "global_data", "console_task", "health",
+              "profiler"),
+    "network": ("wifi_config", "wifi_reconnect", "wifi_store", "ip_config", "net_state",
+                "power_save", "time_sync"),
+    "mqtt": ("mqtt_task", "mqtt_reassembly", "mqtt_tls", "broker_manager", "topic_router",
+             "publish_scheduler", "json_stream", "mqtt_bench"),
+    "sensing": ("dht11_task", "alarm_monitor", "alarm_events", "trend_predict", "rule_engine",
+                "sensor_rules", "history_batch", "batch_codec"),
+    "outputs": ("actuator", "buzzer", "action_scheduler", "timer_wheel", "oled_task"),
+}
+
+# Output sections that live in RAM, by memory
+RAM_SECTIONS = (("dram0", "dram"), ("noinit", "dram"), ("iram0", "iram"), ("rtc", "rtc"))
+
+INPUT_RE = re.compile(r"^ (\S+)\s+0x[0-9a-f]+\s+0x([0-9a-f]+)\s+(\S+)$")
+ADDR_RE = re.compile(r"^\s+0x[0-9a-f]+\s+0x([0-9a-f]+)\s+(\S+)$")
+OBJECT_RE = re.compile(r"(?:^|/)lib([^/]+)\.a\(([^)]+)\)$")
+
+
+def memory_of(output_section):
+    for prefix, memory in RAM_SECTIONS:
+        if output_section.startswith("." + prefix):
+            return memory
+    return None
+
+
+def owner_of(path):
+    """(group, file) for an object path in the map."""
+    match = OBJECT_RE.search(path)
+    if match is None:
+        return "other", path.rsplit("/", 1)[-1]
+    archive, obj = match.groups()
+    if archive != "main":
+        return "idf:" + archive, obj
+    name = obj.split(".", 1)[0]
+    for subsystem, files in SUBSYSTEMS.items():
+        if name in files:
+            return subsystem, name
+    return "main (unassigned)", name
+
+
+def parse_map(lines):
+    """Return {(group, file): {memory: bytes}}."""
+    usage = defaultdict(lambda: defaultdict(int))
+    in_memory_map = False
+    output = None
+    pending = None  # Input section name on its own line
+
+    for line in lines:
+        line = line.rstrip("\n")
+        if not in_memory_map:
+            in_memory_map = line.startswith("Linker script and memory map")
+            continue
+        if line and not line[0].isspace():
+            output = line.split()[0]
+            pending = None
+            continue
+        memory = memory_of(output or "")
+        if memory is None:
+            continue
+
+        match = INPUT_RE.match(line)
+        if match:
+            size, path = int(match.group(2), 16), match.group(3)
+        elif pending is not None and ADDR_RE.match(line):
+            match = ADDR_RE.match(line)
+            size, path = int(match.group(1), 16), match.group(2)
+        else:
+            stripped = line.strip()
+            pending = stripped if line.startswith(" ") and len(stripped.split()) == 1 \
+                and not stripped.startswith(("*", "0x")) else None
+            continue
+        pending = None
+        if size:
+            usage[owner_of(path)][memory] += size
+    return usage
+
+
+def print_table(rows, title=None):
+    if title:
+        print(f"{title:<28} {'DRAM':>8} {'IRAM':>8} {'RTC':>6}")
+    for name, mem in rows:
+        print(f"{name:<28} {mem['dram']:>8} {mem['iram']:>8} {mem['rtc']:>6}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", help="linker map (build/<project>.map)")
+    parser.add_argument("--budget", type=int, help="maximum application DRAM in bytes")
+    parser.add_argument("-v", "--verbose", action="store_true", help="list every source file")
+    args = parser.parse_args()
+
+    with open(args.map, encoding="utf-8", errors="replace") as f:
+        usage = parse_map(f)
+    if not usage:
+        print("no RAM sections found (is this a GNU ld map?)", file=sys.stderr)
+        return 2
+
+    groups = defaultdict(lambda: defaultdict(int))
+    for (group, _), mem in usage.items():
+        for memory, size in mem.items():
+            groups[group][memory] += size
+
+    app = [g for g in groups if not g.startswith("idf:")]
+    app_total = defaultdict(int)
+    for g in app:
+        for memory, size in groups[g].items():
+            app_total[memory] += size
+
+    print_table(sorted(((g, groups[g]) for g in app), key=lambda r: -r[1]["dram"]), "Subsystem")
+    print("-" * 53)
+    print_table([("application total", app_total)])
+    if args.verbose:
+        print()
+        files = sorted(((f"{g}/{name}", mem) for (g, name), mem in usage.items()
+                        if not g.startswith("idf:")), key=lambda r: -r[1]["dram"])
+        print_table(files, "File")
+
+    print()
+    idf = sorted(((g[4:], groups[g]) for g in groups if g.startswith("idf:")),
+                 key=lambda r: -(r[1]["dram"] + r[1]["iram"]))
+    print_table(idf[:15], "ESP-IDF component")
+
+    if args.budget is not None and app_total["dram"] > args.budget:
+        print(f"\nOVER BUDGET: application DRAM {app_total['dram']} > {args.budget}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())